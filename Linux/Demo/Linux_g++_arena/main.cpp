@@ -0,0 +1,217 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "mem_pool.hpp"
+#include "arena.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define ARENA_SIZE      4096
+#define NUM_THREADS     3
+
+
+MemoryPool *arenaPool;
+
+
+//
+//  A short lived object, built up during one processing cycle.
+//
+struct Sample {
+
+    Sample(Sample *next, int value)
+        : Next(next), Value(value)
+    {
+    }
+
+    Sample *Next;
+    int Value;
+};
+
+
+class TestThread : public Thread {
+
+    public:
+
+        TestThread(string name, int seed)
+           : Thread(name, 1000, 1),
+             Seed(seed)
+        {
+            //
+            //  Now that construction is completed, we
+            //  can safely start the thread.
+            //  
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            //
+            //  Each thread borrows its own Arena region from the pool.
+            //
+            Arena arena(*arenaPool);
+            int cycle = 0;
+
+            while (true) {
+
+                //
+                //  Something that lives for the whole cycle.
+                //
+                unsigned char *header = (unsigned char *)arena.Allocate(100, 1);
+                configASSERT(header != NULL);
+                memset(header, Seed, 100);
+
+                int count = 0;
+
+                {
+                    //
+                    //  Everything allocated in here is thrown away
+                    //  at the closing brace.
+                    //
+                    ArenaScope scope(arena);
+                    Sample *head = NULL;
+
+                    while (true) {
+
+                        void *memory = arena.Allocate(sizeof(Sample));
+                        if (memory == NULL) {
+                            break;
+                        }
+
+                        head = new (memory) Sample(head, count++);
+
+                        //
+                        //  Odd sized, odd aligned scratch space in between.
+                        //
+                        if (arena.Allocate(1 + (count % 13), 1 << (count % 6)) == NULL) {
+                            break;
+                        }
+                    }
+
+                    for (Sample *s = head; s != NULL; s = s->Next) {
+                        configASSERT(s->Value == --count);
+                        configASSERT(((uintptr_t)s & (Arena::DefaultAlignment - 1)) == 0);
+                    }
+                }
+
+                configASSERT(arena.GetBytesUsed() == 100);
+                configASSERT(header[99] == (unsigned char)Seed);
+
+                //
+                //  End of cycle, free everything at once.
+                //
+                arena.Reset();
+
+                if (++cycle % 100 == 0) {
+                    cout << GetName() << " ran " << cycle << " cycles" << endl;
+                }
+
+                Delay(Ticks::MsToTicks(10));
+            }
+        };
+
+    private:
+        int Seed;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "Arena Testing" << endl;
+
+    arenaPool = new MemoryPool(ARENA_SIZE, NUM_THREADS, 16);
+
+    TestThread thread1("Thread_1", 1);
+    TestThread thread2("Thread_2", 2);
+    TestThread thread3("Thread_3", 3);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
@@ -83,7 +83,8 @@ class TestThread : public Thread {
         TestThread(string name, int delayInSeconds, int patternStart)
            : Thread(name, 100, 1),
              DelayInSeconds(delayInSeconds),
-             PatternStart(patternStart)
+             PatternStart(patternStart),
+             Batch(false)
         {
             //
             //  Now that construction is completed, we
@@ -107,6 +108,11 @@ class TestThread : public Thread {
                 ticks = Ticks::MsToTicks(1);
                 Delay(ticks);
 
+                //
+                //  Alternate between single item and batch calls.
+                //
+                Batch = !Batch;
+
                 StressPool(pool_1, NUM_POOL_1_ITEMS, 1);
                 StressPool(pool_2, NUM_POOL_2_ITEMS, 2);
                 StressPool(pool_3, NUM_POOL_3_ITEMS, 3);
@@ -127,6 +133,7 @@ class TestThread : public Thread {
     private:
         int DelayInSeconds;
         int PatternStart;
+        bool Batch;
 
         //
         //  Generic function to stress a memory pool.
@@ -146,9 +153,20 @@ class TestThread : public Thread {
             //
             //  Try to allocate the whole pool.
             //
+            int allocated = 0;
+
+            if (Batch) {
+                allocated = p->AllocateBatch((void **)addr, NumPoolItems + 1);
+            }
+
             for (int i = 0; i < NumPoolItems + 1; i++) {
                 
-                addr[i] = (unsigned char*)p->Allocate();
+                if (!Batch) {
+                    addr[i] = (unsigned char*)p->Allocate();
+                }
+                else if (i >= allocated) {
+                    addr[i] = NULL;
+                }
                 
                 //
                 //  If you got an item, fill it with a known pattern,
@@ -170,6 +188,8 @@ class TestThread : public Thread {
             //
             //  Now check and free.
             //
+            int toFree = 0;
+
             for (int i = 0; i < NumPoolItems + 1; i++) {
                 if (addr[i]) {
                     //
@@ -189,11 +209,21 @@ class TestThread : public Thread {
                     //  Poison the memory before freeing it.
                     //
                     memset(addr[i], 0xEE, dataSize);
-                    p->Free(addr[i]);
-                    addr[i] = NULL;
+
+                    if (Batch) {
+                        addr[toFree++] = addr[i];
+                    }
+                    else {
+                        p->Free(addr[i]);
+                        addr[i] = NULL;
+                    }
                 }
             }
 
+            if (Batch) {
+                p->FreeBatch((void **)addr, toFree);
+            }
+
             delete [] addr;
         }
 };
@@ -0,0 +1,199 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "queue.hpp"
+#include "mem_pool.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define NUM_BUFFERS     4
+#define BUFFER_SIZE     32
+
+
+MemoryPool *pool;
+Queue *workQueue;
+
+
+//
+//  The producer is faster than the consumer, so it quickly uses up 
+//  the pool. Instead of polling, it sleeps in Allocate() until the
+//  consumer returns a buffer.
+//
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread()
+           : Thread("producer", 1000, 2)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            unsigned char sequence = 0;
+            int timeouts = 0;
+
+            while (true) {
+
+                unsigned char *buffer = (unsigned char *)
+                    pool->Allocate(Ticks::MsToTicks(1000));
+
+                if (buffer == NULL) {
+                    cout << "producer timed out " << ++timeouts 
+                         << " times" << endl;
+                    continue;
+                }
+
+                memset(buffer, sequence++, BUFFER_SIZE);
+                workQueue->Enqueue(&buffer);
+            }
+        };
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread()
+           : Thread("consumer", 1000, 1)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            unsigned char expected = 0;
+            unsigned char *buffer;
+            int count = 0;
+
+            while (true) {
+
+                workQueue->Dequeue(&buffer);
+
+                //
+                //  Pretend this takes a while.
+                //
+                Delay(Ticks::MsToTicks(10));
+
+                for (int i = 0; i < BUFFER_SIZE; i++) {
+                    configASSERT(buffer[i] == expected);
+                }
+                expected++;
+
+                //
+                //  This wakes the producer if it's blocked.
+                //
+                pool->Free(buffer);
+
+                if (++count >= 100) {
+                    count = 0;
+                    cout << "100 buffers consumed" << endl;
+                }
+            }
+        };
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "MemoryPool blocking Allocate Testing" << endl;
+
+    pool = new MemoryPool(BUFFER_SIZE, NUM_BUFFERS, 8);
+    workQueue = new Queue(NUM_BUFFERS, sizeof(unsigned char *));
+
+    ProducerThread producer;
+    ConsumerThread consumer;
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
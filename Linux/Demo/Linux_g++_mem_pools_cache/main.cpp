@@ -0,0 +1,264 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "queue.hpp"
+#include "mem_pool.hpp"
+#include "mem_pool_cache.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define NUM_POOL_ITEMS      64
+#define POOL_ITEM_SIZE      32
+#define MAGAZINE_SIZE       8
+#define CACHE_TLS_INDEX     0
+#define BURST_SIZE          12
+
+
+MemoryPool *pool;
+MemoryPoolCache *cache;
+Queue *handoff;
+
+
+//
+//  Allocates buffers and hands them to the ConsumerThread, which
+//  frees them. Every free is a "remote" free.
+//
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread()
+           : Thread("producer", 1000, 2)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            unsigned char pattern = 0;
+
+            while (true) {
+
+                for (int i = 0; i < BURST_SIZE; i++) {
+
+                    unsigned char *item = (unsigned char *)cache->Allocate();
+                    configASSERT(item != NULL);
+
+                    memset(item, pattern, POOL_ITEM_SIZE);
+                    pattern++;
+
+                    handoff->Enqueue(&item);
+                }
+
+                Delay(Ticks::MsToTicks(5));
+            }
+        };
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread()
+           : Thread("consumer", 1000, 2)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            unsigned char pattern = 0;
+            unsigned char *item;
+
+            while (true) {
+
+                handoff->Dequeue(&item);
+
+                for (int i = 0; i < POOL_ITEM_SIZE; i++) {
+                    configASSERT(item[i] == pattern);
+                }
+                pattern++;
+
+                cache->Free(item);
+            }
+        };
+};
+
+
+//
+//  Allocates and frees its own buffers, the best case for the cache.
+//
+class LocalThread : public Thread {
+
+    public:
+
+        LocalThread()
+           : Thread("local", 1000, 2)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            void *items[MAGAZINE_SIZE];
+
+            while (true) {
+
+                for (int i = 0; i < MAGAZINE_SIZE; i++) {
+                    items[i] = cache->Allocate();
+                    configASSERT(items[i] != NULL);
+                }
+
+                for (int i = 0; i < MAGAZINE_SIZE; i++) {
+                    cache->Free(items[i]);
+                }
+
+                Delay(1);
+            }
+        };
+};
+
+
+class ReportThread : public Thread {
+
+    public:
+
+        ReportThread()
+           : Thread("report", 1000, 3)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            MemoryPoolCacheStats stats;
+
+            while (true) {
+
+                Delay(Ticks::SecondsToTicks(2));
+
+                cache->GetStats(stats);
+
+                unsigned long ops = stats.Allocations + stats.Frees;
+                unsigned long hits = stats.AllocationHits + stats.FreeHits;
+
+                cout << "allocs " << stats.Allocations 
+                     << " frees " << stats.Frees
+                     << " hit rate " << (ops ? (hits * 100) / ops : 0) << "%"
+                     << " pool locks " << stats.PoolLocks
+                     << " saved " << stats.PoolLocksSaved << endl;
+            }
+        };
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "MemoryPoolCache Testing" << endl;
+
+    pool = new MemoryPool(POOL_ITEM_SIZE, NUM_POOL_ITEMS, 8);
+    cache = new MemoryPoolCache(*pool, CACHE_TLS_INDEX, MAGAZINE_SIZE);
+    handoff = new Queue(BURST_SIZE, sizeof(unsigned char *));
+
+    ProducerThread producer;
+    ConsumerThread consumer;
+    LocalThread local;
+    ReportThread report;
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
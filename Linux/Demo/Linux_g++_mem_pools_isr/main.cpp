@@ -0,0 +1,219 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "queue.hpp"
+#include "tickhook.hpp"
+#include "mem_pool.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define NUM_BUFFERS     8
+#define BUFFER_SIZE     64
+
+
+MemoryPool *pool;
+Queue *rxQueue;
+
+
+//
+//  Pretend the tick interrupt is a DMA completion. Grab a buffer
+//  from the pool, fill it in, and hand the pointer to a task.
+//
+class DmaCompleteHook : public TickHook {
+
+    public:
+        DmaCompleteHook() 
+            : TickHook(), 
+              Dropped(0),
+              Sequence(0)
+        {
+            Register();
+        }
+
+        volatile unsigned long Dropped;
+
+    protected:
+        void Run() {
+
+            unsigned char *buffer = (unsigned char *)pool->AllocateFromISR();
+
+            if (buffer == NULL) {
+                Dropped++;
+                return;
+            }
+
+            memset(buffer, Sequence, BUFFER_SIZE);
+
+            BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+            if (rxQueue->EnqueueFromISR(&buffer, &higherPriorityTaskWoken)) {
+                Sequence++;
+            }
+            else {
+                pool->FreeFromISR(buffer, &higherPriorityTaskWoken);
+                Dropped++;
+            }
+        }
+
+    private:
+        unsigned char Sequence;
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread(DmaCompleteHook &hook)
+           : Thread("consumer", 1000, 2),
+             Hook(hook)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            unsigned char expected = 0;
+            unsigned char *buffer;
+            int count = 0;
+
+            while (true) {
+
+                rxQueue->Dequeue(&buffer);
+
+                for (int i = 0; i < BUFFER_SIZE; i++) {
+                    configASSERT(buffer[i] == expected);
+                }
+                expected++;
+
+                //
+                //  The buffer came straight from the ISR, no copies.
+                //  We own it now, so give it back to the pool.
+                //
+                pool->Free(buffer);
+
+                if (++count >= 1000) {
+                    count = 0;
+                    cout << "1000 buffers received from ISR, "
+                         << Hook.Dropped << " dropped so far" << endl;
+
+                    //
+                    //  A low water mark of zero means the ISR has
+                    //  run the pool dry at least once.
+                    //
+                    MemoryPoolStats stats;
+                    pool->GetStats(stats);
+                    cout << "pool: low water " << stats.LowWaterMark
+                         << " of " << stats.TotalItems
+                         << ", peak " << stats.PeakUsage
+                         << ", " << stats.FailedAllocations 
+                         << " failed allocations" << endl;
+                }
+            }
+        };
+
+    private:
+        DmaCompleteHook &Hook;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "MemoryPool ISR Testing" << endl;
+
+    pool = new MemoryPool(BUFFER_SIZE, NUM_BUFFERS, 8);
+    rxQueue = new Queue(NUM_BUFFERS, sizeof(unsigned char *));
+
+    DmaCompleteHook hook;
+    ConsumerThread consumer(hook);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
@@ -0,0 +1,275 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "mem_pool.hpp"
+#include "lock_free_mem_pool.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define NUM_POOL_ITEMS          32
+#define POOL_ITEM_SIZE          64
+#define NUM_BENCHMARK_THREADS   4
+#define OPS_PER_ROUND           1000
+#define ROUNDS_PER_RUN          200
+
+
+MemoryPool *mutexPool;
+LockFreeMemoryPool *lockFreePool;
+
+
+//
+//  Adapters so the same benchmark loop can drive either pool.
+//
+class PoolAdapter {
+    public:
+        virtual void *Allocate() = 0;
+        virtual void Free(void *item) = 0;
+        virtual const char *Name() = 0;
+        virtual ~PoolAdapter() {}
+};
+
+
+class MutexPoolAdapter : public PoolAdapter {
+    public:
+        virtual void *Allocate() { return mutexPool->Allocate(); }
+        virtual void Free(void *item) { mutexPool->Free(item); }
+        virtual const char *Name() { return "MemoryPool"; }
+};
+
+
+class LockFreePoolAdapter : public PoolAdapter {
+    public:
+        virtual void *Allocate() { return lockFreePool->Allocate(); }
+        virtual void Free(void *item) { lockFreePool->Free(item); }
+        virtual const char *Name() { return "LockFreeMemoryPool"; }
+};
+
+
+class BenchmarkThread : public Thread {
+
+    public:
+
+        BenchmarkThread(string name, PoolAdapter *pool, unsigned char pattern)
+           : Thread(name, 1000, 2),
+             Ops(0),
+             Failures(0),
+             Done(false),
+             Pool(pool),
+             Pattern(pattern)
+        {
+            Start();
+        };
+
+        unsigned long Ops;
+        unsigned long Failures;
+        volatile bool Done;
+
+    protected:
+
+        virtual void Run() {
+
+            void *items[4];
+
+            for (int round = 0; round < ROUNDS_PER_RUN; round++) {
+
+                for (int i = 0; i < OPS_PER_ROUND; i++) {
+
+                    for (int j = 0; j < 4; j++) {
+                        items[j] = Pool->Allocate();
+                        if (items[j]) {
+                            memset(items[j], Pattern, POOL_ITEM_SIZE);
+                        }
+                        else {
+                            Failures++;
+                        }
+                    }
+
+                    for (int j = 0; j < 4; j++) {
+                        if (items[j]) {
+                            configASSERT(((unsigned char *)items[j])[POOL_ITEM_SIZE - 1] == Pattern);
+                            Pool->Free(items[j]);
+                            Ops += 2;
+                        }
+                    }
+                }
+
+                //
+                //  Let the other benchmark threads in.
+                //
+                Yield();
+            }
+
+            Done = true;
+
+            while (true) {
+                Delay(Ticks::SecondsToTicks(10));
+            }
+        };
+
+    private:
+        PoolAdapter *Pool;
+        unsigned char Pattern;
+};
+
+
+class ControlThread : public Thread {
+
+    public:
+
+        ControlThread()
+           : Thread("control", 1000, 3)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            MutexPoolAdapter mutexAdapter;
+            LockFreePoolAdapter lockFreeAdapter;
+
+            while (true) {
+                RunBenchmark(&mutexAdapter);
+                RunBenchmark(&lockFreeAdapter);
+                Delay(Ticks::SecondsToTicks(1));
+            }
+        };
+
+    private:
+
+        void RunBenchmark(PoolAdapter *pool) {
+
+            BenchmarkThread *threads[NUM_BENCHMARK_THREADS];
+
+            TickType_t start = Ticks::GetTicks();
+
+            for (int i = 0; i < NUM_BENCHMARK_THREADS; i++) {
+                threads[i] = new BenchmarkThread("bench", pool, (unsigned char)(i + 1));
+            }
+
+            unsigned long ops = 0;
+            unsigned long failures = 0;
+
+            for (int i = 0; i < NUM_BENCHMARK_THREADS; i++) {
+                while (!threads[i]->Done) {
+                    Delay(1);
+                }
+                ops += threads[i]->Ops;
+                failures += threads[i]->Failures;
+            }
+
+            TickType_t elapsed = Ticks::GetTicks() - start;
+            if (elapsed == 0) {
+                elapsed = 1;
+            }
+
+            cout << pool->Name() << ": "
+                 << ops << " ops in " << Ticks::TicksToMs(elapsed) << " ms = "
+                 << (ops * 1000ULL) / Ticks::TicksToMs(elapsed) << " ops/sec ("
+                 << failures << " empty pool misses)" << endl;
+
+            for (int i = 0; i < NUM_BENCHMARK_THREADS; i++) {
+                delete threads[i];
+            }
+        }
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "MemoryPool vs LockFreeMemoryPool benchmark" << endl;
+
+    mutexPool = new MemoryPool(POOL_ITEM_SIZE, NUM_POOL_ITEMS, 8);
+    lockFreePool = new LockFreeMemoryPool(POOL_ITEM_SIZE, NUM_POOL_ITEMS, 8);
+
+    ControlThread control;
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
@@ -0,0 +1,221 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "static_mem_pool.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define NUM_MESSAGES    10
+#define NUM_SAMPLES     10
+
+
+class Message {
+
+    public:
+        Message(int id, unsigned char pattern)
+            : Id(id),
+              Pattern(pattern)
+        {
+            memset(Payload, pattern, sizeof(Payload));
+            LiveCount++;
+        }
+
+        ~Message()
+        {
+            memset(Payload, 0xEE, sizeof(Payload));
+            LiveCount--;
+        }
+
+        void Verify()
+        {
+            for (unsigned int i = 0; i < sizeof(Payload); i++) {
+                configASSERT(Payload[i] == Pattern);
+            }
+        }
+
+        int Id;
+        unsigned char Pattern;
+        unsigned char Payload[50];
+
+        static volatile int LiveCount;
+};
+
+volatile int Message::LiveCount = 0;
+
+
+//
+//  Both pools live in .bss, their geometry is fixed at compile time.
+//
+static StaticMemoryPool<Message, NUM_MESSAGES> MessagePool;
+static StaticMemoryPool<double, NUM_SAMPLES, 32> SamplePool;
+
+static_assert(StaticMemoryPool<double, NUM_SAMPLES, 32>::ItemSize == 32,
+              "Samples should be padded out to their alignment");
+
+
+class TestThread : public Thread {
+
+    public:
+
+        TestThread(string name, unsigned char pattern)
+           : Thread(name, 1000, 1),
+             Pattern(pattern)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            int run_cnt = 0;
+
+            while (true) {
+
+                Message *messages[NUM_MESSAGES + 1];
+                double *samples[NUM_SAMPLES + 1];
+
+                //
+                //  Try to take the whole pools.
+                //
+                for (int i = 0; i < NUM_MESSAGES + 1; i++) {
+                    messages[i] = MessagePool.Construct(i, Pattern);
+                }
+
+                for (int i = 0; i < NUM_SAMPLES + 1; i++) {
+                    samples[i] = (double *)SamplePool.Allocate();
+                    if (samples[i]) {
+                        configASSERT(((uintptr_t)samples[i] & 31) == 0);
+                        *samples[i] = Pattern;
+                    }
+                }
+
+                //
+                //  Wait a bit so the threads compete for the pools.
+                //
+                Delay(Ticks::MsToTicks(Pattern));
+
+                for (int i = 0; i < NUM_MESSAGES + 1; i++) {
+                    if (messages[i]) {
+                        configASSERT(messages[i]->Id == i);
+                        messages[i]->Verify();
+                        MessagePool.Destroy(messages[i]);
+                    }
+                }
+
+                for (int i = 0; i < NUM_SAMPLES + 1; i++) {
+                    if (samples[i]) {
+                        configASSERT(*samples[i] == Pattern);
+                        SamplePool.Free(samples[i]);
+                    }
+                }
+
+                if (run_cnt++ > 100) {
+                    run_cnt = 0;
+                    cout << "Running thread " << GetName() 
+                         << ", live messages " << Message::LiveCount << endl;
+                }
+            }
+        };
+
+    private:
+        unsigned char Pattern;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "StaticMemoryPool Testing" << endl;
+
+    TestThread thread1("Thread_1", 1);
+    TestThread thread2("Thread_2", 3);
+    TestThread thread3("Thread_3", 5);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
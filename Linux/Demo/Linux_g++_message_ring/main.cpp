@@ -0,0 +1,213 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "tickhook.hpp"
+#include "message_ring.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define RING_SIZE       1024
+#define MAX_SAMPLES     32
+
+
+//
+//  A variable length telemetry record, sized to the number of 
+//  samples actually taken.
+//
+struct Record {
+    int Sequence;
+    int NumSamples;
+    unsigned char Samples[1];
+};
+
+
+MessageRing *telemetry;
+
+
+//
+//  Pretend to be a sampling interrupt. Records are built directly
+//  in the ring, a full ring just drops the record.
+//
+class SamplerHook : public TickHook {
+
+    public:
+
+        SamplerHook()
+            : TickHook(),
+              Dropped(0),
+              Sequence(0)
+        {
+            Register();
+        }
+
+        int Dropped;
+
+    protected:
+
+        void Run() {
+
+            int numSamples = 1 + (Sequence % MAX_SAMPLES);
+            int size = (int)(sizeof(Record) - 1 + numSamples);
+
+            Record *record = (Record *)telemetry->ReserveFromISR(size);
+            if (record == NULL) {
+                Dropped++;
+                Sequence++;
+                return;
+            }
+
+            record->Sequence = Sequence;
+            record->NumSamples = numSamples;
+            for (int i = 0; i < numSamples; i++) {
+                record->Samples[i] = (unsigned char)(Sequence + i);
+            }
+
+            telemetry->CommitFromISR(size);
+            Sequence++;
+        }
+
+    private:
+        int Sequence;
+};
+
+
+SamplerHook *sampler;
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread()
+           : Thread("consumer", 1000, 1)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            int last = -1;
+            int count = 0;
+
+            while (true) {
+
+                int size;
+                Record *record = (Record *)telemetry->Peek(size);
+                configASSERT(record != NULL);
+
+                configASSERT(record->Sequence > last);
+                configASSERT(size == (int)(sizeof(Record) - 1 + record->NumSamples));
+                for (int i = 0; i < record->NumSamples; i++) {
+                    configASSERT(record->Samples[i] == (unsigned char)(record->Sequence + i));
+                }
+                last = record->Sequence;
+
+                telemetry->Release();
+
+                if (++count >= 1000) {
+                    count = 0;
+                    cout << "consumer received 1000 records, " 
+                         << sampler->Dropped << " dropped so far" << endl;
+                }
+            }
+        };
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "MessageRing Testing" << endl;
+
+    telemetry = new MessageRing(RING_SIZE);
+    sampler = new SamplerHook();
+
+    ConsumerThread consumer;
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
@@ -0,0 +1,205 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "overwriting_queue.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+struct Sample {
+    TickType_t Timestamp;
+    int Value;
+};
+
+
+#define NUM_SAMPLES     16
+
+
+typedef OverwritingQueue<Sample, NUM_SAMPLES> TelemetryQueue_t;
+
+
+class SensorThread : public Thread {
+
+    public:
+
+        SensorThread(int periodInMs, TelemetryQueue_t &q)
+           : Thread("SensorThread", 100, 2), 
+             PeriodInMs(periodInMs),
+             Telemetry(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting SensorThread" << endl;
+            Sample sample;
+            sample.Value = 0;
+
+            while (true) {
+
+                Delay(Ticks::MsToTicks(PeriodInMs));
+
+                //
+                //  Never waits, however far behind the logger is.
+                //
+                sample.Timestamp = Ticks::GetTicks();
+                Telemetry.Enqueue(sample);
+                sample.Value++;
+            }
+        };
+
+    private:
+        int PeriodInMs;
+        TelemetryQueue_t &Telemetry;
+};
+
+
+class LoggerThread : public Thread {
+
+    public:
+
+        LoggerThread(int periodInMs, TelemetryQueue_t &q)
+           : Thread("LoggerThread", 1000, 1), 
+             PeriodInMs(periodInMs),
+             Telemetry(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting LoggerThread" << endl;
+            Sample samples[NUM_SAMPLES];
+
+            while (true) {
+
+                size_t n = Telemetry.DequeueMany(samples, NUM_SAMPLES);
+
+                cout << "Logged " << n << " samples, " 
+                     << samples[0].Value << " to " << samples[n - 1].Value
+                     << ", newest at tick " << samples[n - 1].Timestamp
+                     << ", " << Telemetry.Dropped() << " dropped so far" << endl;
+
+                //
+                //  Slower than the sensor, so the oldest samples get
+                //  dropped instead of the sensor being held up.
+                //
+                Delay(Ticks::MsToTicks(PeriodInMs));
+            }
+        };
+
+    private:
+        int PeriodInMs;
+        TelemetryQueue_t &Telemetry;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "OverwritingQueue telemetry" << endl;
+
+    TelemetryQueue_t *Telemetry;
+
+    try {
+        Telemetry = new TelemetryQueue_t();
+    }
+    catch(QueueCreateException &ex) {
+        cout << "Caught QueueCreateException" << endl;
+        cout << ex.what() << endl;
+        configASSERT(!"Queue creation failed!");
+    }
+
+    SensorThread sensor(10, *Telemetry);
+    LoggerThread logger(500, *Telemetry);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
+
@@ -0,0 +1,213 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "priority_queue.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+struct Message {
+    int Priority;
+    int Id;
+};
+
+
+//
+//  Higher Priority values come out first.
+//
+struct ByPriority {
+    bool operator()(const Message &a, const Message &b) const {
+        return a.Priority < b.Priority;
+    }
+};
+
+
+typedef PriorityQueue<Message, 16, ByPriority> MessageQueue_t;
+
+
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread(string name, int priority, int burstAmount, int delayInMs, MessageQueue_t &q)
+           : Thread(name, 100, 1), 
+             Priority(priority),
+             BurstAmount(burstAmount),
+             DelayInMs(delayInMs),
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting " << GetName() << endl;
+            Message message;
+            message.Priority = Priority;
+            message.Id = 0;
+
+            while (true) {
+
+                Delay(Ticks::MsToTicks(DelayInMs));
+                for (int i = 0; i < BurstAmount; i++) {
+                    MessageQueue.Enqueue(message);
+                    message.Id++;
+                }
+            }
+        };
+
+    private:
+        int Priority;
+        int BurstAmount;
+        int DelayInMs;
+        MessageQueue_t &MessageQueue;
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread(MessageQueue_t &q)
+           : Thread("ConsumerThread", 100, 1), 
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ConsumerThread" << endl;
+            Message message;
+
+            while (true) {
+
+                MessageQueue.Dequeue(message);
+                cout << "Received Priority " << message.Priority 
+                     << " Message " << message.Id 
+                     << " (" << MessageQueue.NumItems() << " waiting)" << endl;
+
+                //
+                //  A slow consumer, so the bulk data backs up and the
+                //  urgent messages have something to overtake.
+                //
+                Delay(Ticks::MsToTicks(100));
+            }
+        };
+
+    private:
+        MessageQueue_t &MessageQueue;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "PriorityQueue Urgent / Bulk Producers" << endl;
+
+    MessageQueue_t *MessageQueue;
+
+    try {
+        MessageQueue = new MessageQueue_t();
+    }
+    catch(QueueCreateException &ex) {
+        cout << "Caught QueueCreateException" << endl;
+        cout << ex.what() << endl;
+        configASSERT(!"Queue creation failed!");
+    }
+
+    ProducerThread bulk("BulkProducer", 0, 8, 500, *MessageQueue);
+    ProducerThread status("StatusProducer", 1, 1, 700, *MessageQueue);
+    ProducerThread urgent("UrgentProducer", 2, 1, 1300, *MessageQueue);
+
+    ConsumerThread consumer(*MessageQueue);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
+
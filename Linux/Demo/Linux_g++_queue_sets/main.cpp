@@ -0,0 +1,243 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "queue.hpp"
+#include "semaphore.hpp"
+#include "typed_queue.hpp"
+#include "queue_set.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define SENSOR_QUEUE_SIZE   4
+#define COMMAND_QUEUE_SIZE  2
+#define MAX_ALARMS          4
+
+
+struct Command {
+    int Code;
+    int Argument;
+};
+
+
+Queue *SensorQueue;
+TypedQueue<Command> *CommandQueue;
+CountingSemaphore *Alarm;
+
+
+class SensorThread : public Thread {
+
+    public:
+
+        SensorThread()
+           : Thread("SensorThread", 100, 2)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            int Reading = 0;
+
+            while (true) {
+                Delay(Ticks::MsToTicks(100));
+                SensorQueue->Enqueue(&Reading);
+                Reading++;
+            }
+        };
+};
+
+
+class CommandThread : public Thread {
+
+    public:
+
+        CommandThread()
+           : Thread("CommandThread", 100, 2)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            int Code = 0;
+
+            while (true) {
+                Delay(Ticks::MsToTicks(350));
+                CommandQueue->Enqueue(Command{Code, Code * 10});
+                Code++;
+
+                if (Code % 5 == 0) {
+                    Alarm->Give();
+                }
+            }
+        };
+};
+
+
+//
+//  Waits on all three sources at once, without polling.
+//
+class GatewayThread : public Thread {
+
+    public:
+
+        GatewayThread(QueueSet &set)
+           : Thread("GatewayThread", 100, 1),
+             Set(set)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting GatewayThread" << endl;
+
+            while (true) {
+
+                QueueSet::Member Ready = Set.Select(Ticks::SecondsToTicks(2));
+
+                if (Ready.TimedOut()) {
+                    cout << "[G] Nothing for 2 seconds" << endl;
+                }
+                else if (Ready == *SensorQueue) {
+                    int Reading;
+                    SensorQueue->Dequeue(&Reading, 0);
+                    if (Reading % 10 == 0) {
+                        cout << "[G] Sensor reading " << Reading << endl;
+                    }
+                }
+                else if (Ready == *CommandQueue) {
+                    Command command;
+                    CommandQueue->Dequeue(command, 0);
+                    cout << "[G] Command " << command.Code 
+                         << " (" << command.Argument << ")" << endl;
+                }
+                else if (Ready == *Alarm) {
+                    Alarm->Take(0);
+                    cout << "[G] Alarm!" << endl;
+                }
+                else {
+                    configASSERT(!"Unknown queue set member");
+                }
+            }
+        };
+
+    private:
+        QueueSet &Set;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "Queue Sets" << endl;
+
+    SensorQueue = new Queue(SENSOR_QUEUE_SIZE, sizeof(int));
+    CommandQueue = new TypedQueue<Command>(COMMAND_QUEUE_SIZE);
+    Alarm = new CountingSemaphore(MAX_ALARMS, 0);
+
+    //
+    //  Room for every item and count the members can hold.
+    //
+    QueueSet *Set = new QueueSet(SENSOR_QUEUE_SIZE + COMMAND_QUEUE_SIZE + MAX_ALARMS);
+
+    Set->Add(*SensorQueue);
+    Set->Add(*CommandQueue);
+    Set->Add(*Alarm);
+
+    SensorThread sensor;
+    CommandThread command;
+    GatewayThread gateway(*Set);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
+
@@ -0,0 +1,198 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "queue.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define QUEUE_SIZE      16
+#define MAX_BURST       8
+
+
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread(Queue &q)
+           : Thread("ProducerThread", 100, 2), 
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ProducerThread" << endl;
+            int Messages[MAX_BURST];
+            int Sequence = 0;
+            int BurstSize = 1;
+
+            while (true) {
+                
+                Delay(Ticks::MsToTicks(500));
+
+                for (int i = 0; i < BurstSize; i++) {
+                    Messages[i] = Sequence++;
+                }
+
+                UBaseType_t sent = MessageQueue.EnqueueMany(Messages, BurstSize);
+                configASSERT(sent == (UBaseType_t)BurstSize);
+
+                cout << "[P] Sent a burst of " << BurstSize << endl;
+
+                BurstSize = BurstSize % MAX_BURST + 1;
+            }
+        };
+
+    private:
+        Queue &MessageQueue;
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread(Queue &q)
+           : Thread("ConsumerThread", 100, 1), 
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ConsumerThread" << endl;
+            int Messages[MAX_BURST];
+            int Expected = 0;
+
+            while (true) {
+                
+                //
+                //  One wake up per burst, however big it was.
+                //
+                UBaseType_t received = MessageQueue.DequeueMany(Messages, MAX_BURST);
+
+                for (UBaseType_t i = 0; i < received; i++) {
+                    configASSERT(Messages[i] == Expected);
+                    Expected++;
+                }
+
+                cout << "[C] Received " << received << " messages at once" << endl;
+            }
+        };
+
+    private:
+        Queue &MessageQueue;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "Queues Batch Enqueue / Dequeue" << endl;
+
+    Queue *MessageQueue;
+
+    try {
+        MessageQueue = new Queue(QUEUE_SIZE, sizeof(int));
+    }
+    catch(QueueCreateException &ex) {
+        cout << "Caught QueueCreateException" << endl;
+        cout << ex.what() << endl;
+        configASSERT(!"Queue creation failed!");
+    }
+
+    ProducerThread p1(*MessageQueue);
+    ConsumerThread c1(*MessageQueue);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
+
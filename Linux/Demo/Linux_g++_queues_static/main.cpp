@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "static_queue.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+struct Message {
+    int Sequence;
+    int Value;
+};
+
+
+#define QUEUE_SIZE      4
+#define BURST_SIZE      QUEUE_SIZE
+
+
+//
+//  Both queues live in .bss, neither one touches the FreeRTOS heap.
+//  The request queue carries its own storage, the reply queue uses 
+//  buffers we hand it.
+//
+StaticQueue<Message, QUEUE_SIZE> RequestQueue;
+
+uint8_t ReplyStorage[QUEUE_SIZE * sizeof(int)];
+StaticQueue_t ReplyQueueBuffer;
+TypedQueue<int> ReplyQueue(QUEUE_SIZE, ReplyStorage, &ReplyQueueBuffer);
+
+
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread()
+           : Thread("ProducerThread", 100, 1)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ProducerThread" << endl;
+            int Sequence = 0;
+
+            while (true) {
+                
+                Delay(Ticks::SecondsToTicks(1));
+
+                for (int i = 0; i < BURST_SIZE; i++) {
+                    RequestQueue.Enqueue(Message{Sequence, Sequence * Sequence});
+                    Sequence++;
+                }
+
+                for (int i = 0; i < BURST_SIZE; i++) {
+                    int Reply;
+                    ReplyQueue.Dequeue(Reply);
+                    configASSERT(Reply == Sequence - BURST_SIZE + i);
+                }
+
+                cout << "[P] " << Sequence << " messages acknowledged" << endl;
+            }
+        };
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread()
+           : Thread("ConsumerThread", 100, 1)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ConsumerThread" << endl;
+            Message message;
+
+            while (true) {
+                
+                RequestQueue.Dequeue(message);
+                configASSERT(message.Value == message.Sequence * message.Sequence);
+                ReplyQueue.Enqueue(message.Sequence);
+            }
+        };
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "Statically Allocated Queues" << endl;
+
+    ProducerThread p1;
+    ConsumerThread c1;
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+//
+//  With configSUPPORT_STATIC_ALLOCATION the kernel asks us for
+//  the memory for its own tasks.
+//
+extern "C" void vApplicationGetIdleTaskMemory(  StaticTask_t **ppxIdleTaskTCBBuffer,
+                                                StackType_t **ppxIdleTaskStackBuffer,
+                                                uint32_t *pulIdleTaskStackSize);
+void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer,
+                                    StackType_t **ppxIdleTaskStackBuffer,
+                                    uint32_t *pulIdleTaskStackSize)
+{
+    static StaticTask_t IdleTaskTCB;
+    static StackType_t IdleTaskStack[configMINIMAL_STACK_SIZE];
+
+    *ppxIdleTaskTCBBuffer = &IdleTaskTCB;
+    *ppxIdleTaskStackBuffer = IdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+
+extern "C" void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer,
+                                                StackType_t **ppxTimerTaskStackBuffer,
+                                                uint32_t *pulTimerTaskStackSize);
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                                    StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize)
+{
+    static StaticTask_t TimerTaskTCB;
+    static StackType_t TimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+
+    *ppxTimerTaskTCBBuffer = &TimerTaskTCB;
+    *ppxTimerTaskStackBuffer = TimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
+
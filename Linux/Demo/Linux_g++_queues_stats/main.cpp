@@ -0,0 +1,242 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "queue.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread(int i, int delayInSeconds, int burstAmount, Queue &q)
+           : Thread("ProducerThread", 100, 1), 
+             Id (i), 
+             DelayInSeconds(delayInSeconds),
+             BurstAmount(burstAmount),
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ProducerThread " << Id << endl;
+            int Message = 0;
+
+            while (true) {
+                
+                Delay(Ticks::SecondsToTicks(DelayInSeconds));
+                for (int i = 0; i < BurstAmount; i++) {
+                    MessageQueue.Enqueue(&Message);
+                    Message++;
+                }
+            }
+        };
+
+    private:
+        int Id;
+        int DelayInSeconds;
+        int BurstAmount;
+        Queue &MessageQueue;
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread(int i, int delayInMs, Queue &q)
+           : Thread("ConsumerThread", 100, 1), 
+             Id (i), 
+             DelayInMs(delayInMs),
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ConsumerThread " << Id << endl;
+            int Message;
+
+            while (true) {
+                
+                MessageQueue.Dequeue(&Message);
+                Delay(Ticks::MsToTicks(DelayInMs));
+            }
+        };
+
+    private:
+        int Id;
+        int DelayInMs;
+        Queue &MessageQueue;
+};
+
+
+class MonitorThread : public Thread {
+
+    public:
+
+        MonitorThread(int delayInSeconds, Queue &q)
+           : Thread("MonitorThread", 1000, 2), 
+             DelayInSeconds(delayInSeconds),
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            QueueStats stats;
+
+            while (true) {
+
+                Delay(Ticks::SecondsToTicks(DelayInSeconds));
+
+                MessageQueue.GetStats(stats);
+
+                cout << "Queue: peak depth " << stats.PeakDepth
+                     << ", " << stats.Enqueues << " enqueues"
+                     << ", " << stats.Dequeues << " dequeues"
+                     << ", " << stats.EnqueueTimeouts << " / " 
+                     << stats.DequeueTimeouts << " timeouts" << endl;
+
+                cout << "  producers blocked " 
+                     << Ticks::TicksToMs(stats.ProducerBlockedTicks) << " ms"
+                     << ", consumers blocked " 
+                     << Ticks::TicksToMs(stats.ConsumerBlockedTicks) << " ms" << endl;
+
+                cout << "  residency (ticks):";
+                for (int i = 0; i < CPP_FREERTOS_QUEUE_STATS_BUCKETS; i++) {
+                    if (stats.Residency[i] != 0) {
+                        cout << " <" << (1UL << i) << ":" << stats.Residency[i];
+                    }
+                }
+                cout << endl;
+            }
+        };
+
+    private:
+        int DelayInSeconds;
+        Queue &MessageQueue;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "Queue Statistics" << endl;
+
+    //
+    //  These parameters may be adjusted to explore queue 
+    //  behaviors. Bursts of 10 into a queue of 5, drained every 
+    //  150 ms, so the producer spends most of a burst blocked.
+    //
+    Queue *MessageQueue;
+
+    try {
+        MessageQueue = new Queue(5, sizeof(int));
+    }
+    catch(QueueCreateException &ex) {
+        cout << "Caught QueueCreateException" << endl;
+        cout << ex.what() << endl;
+        configASSERT(!"Queue creation failed!");
+    }
+
+    ProducerThread p1(1, 1, 10, *MessageQueue);
+    ConsumerThread c1(1, 150, *MessageQueue);
+    MonitorThread m1(5, *MessageQueue);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
+
@@ -0,0 +1,204 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "typed_queue.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+//
+//  Anything trivially copyable can go through a TypedQueue.
+//
+struct Message {
+    int Producer;
+    int Sequence;
+};
+
+
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread(int i, int delayInSeconds, int burstAmount, TypedQueue<Message> &q)
+           : Thread("ProducerThread", 100, 1), 
+             Id (i), 
+             DelayInSeconds(delayInSeconds),
+             BurstAmount(burstAmount),
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ProducerThread " << Id << endl;
+            int Sequence = 0;
+
+            while (true) {
+                
+                Delay(Ticks::SecondsToTicks(DelayInSeconds));
+                for (int i = 0; i < BurstAmount; i++) {
+                    cout << "[P" << Id << "] Sending Message: " << Sequence << endl;
+                    MessageQueue.Enqueue(Message{Id, Sequence});
+                    Sequence++;
+                }
+            }
+        };
+
+    private:
+        int Id;
+        int DelayInSeconds;
+        int BurstAmount;
+        TypedQueue<Message> &MessageQueue;
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread(int i, int delayInSeconds, TypedQueue<Message> &q)
+           : Thread("ConsumerThread", 100, 1), 
+             Id (i), 
+             DelayInSeconds(delayInSeconds),
+             MessageQueue(q)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            cout << "Starting ConsumerThread " << Id << endl;
+            Message message;
+            int Expected = 0;
+
+            while (true) {
+                
+                MessageQueue.Dequeue(message);
+                configASSERT(message.Sequence == Expected);
+                Expected++;
+                cout << "[C" << Id << "] Received Message: " << message.Sequence 
+                     << " from P" << message.Producer << endl;
+                Delay(Ticks::SecondsToTicks(DelayInSeconds));
+            }
+        };
+
+    private:
+        int Id;
+        int DelayInSeconds;
+        TypedQueue<Message> &MessageQueue;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "Typed Queues Simple Producer / Consumer" << endl;
+
+    //
+    //  These parameters may be adjusted to explore queue 
+    //  behaviors.
+    //
+    TypedQueue<Message> *MessageQueue;
+
+    try {
+        MessageQueue = new TypedQueue<Message>(1);
+    }
+    catch(QueueCreateException &ex) {
+        cout << "Caught QueueCreateException" << endl;
+        cout << ex.what() << endl;
+        configASSERT(!"Queue creation failed!");
+    }
+
+    ProducerThread p1(1, 1, 10, *MessageQueue);
+    ConsumerThread c1(1, 1, *MessageQueue);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
+
@@ -0,0 +1,215 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "queue.hpp"
+#include "mem_pool.hpp"
+#include "shared_buffer.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define NUM_FRAMES      4
+#define FRAME_SIZE      128
+#define NUM_CONSUMERS   3
+
+
+MemoryPool *framePool;
+Queue *frameQueues[NUM_CONSUMERS];
+
+
+//
+//  Pretend to be a sensor. Each frame is filled in once and then
+//  handed to every consumer, without any copies.
+//
+class SensorThread : public Thread {
+
+    public:
+
+        SensorThread()
+           : Thread("sensor", 1000, 2)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            unsigned char sequence = 0;
+
+            while (true) {
+
+                //
+                //  Blocks until every consumer is done with an 
+                //  older frame.
+                //
+                SharedBuffer frame = SharedBuffer::Allocate(*framePool, portMAX_DELAY);
+                configASSERT(frame.IsValid());
+
+                memset(frame.GetData(), sequence++, frame.GetSize());
+
+                for (int i = 0; i < NUM_CONSUMERS; i++) {
+                    void *token = frame.Share();
+                    frameQueues[i]->Enqueue(&token);
+                }
+
+                //
+                //  Our own reference goes away here, the last 
+                //  consumer to finish returns the frame to the pool.
+                //
+            }
+        };
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread(string name, int index)
+           : Thread(name, 1000, 1),
+             Index(index)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            unsigned char expected = 0;
+            int count = 0;
+
+            while (true) {
+
+                void *token;
+                frameQueues[Index]->Dequeue(&token);
+
+                SharedBuffer frame = SharedBuffer::Adopt(token);
+                unsigned char *data = (unsigned char *)frame.GetData();
+
+                for (int i = 0; i < frame.GetSize(); i++) {
+                    configASSERT(data[i] == expected);
+                }
+                expected++;
+
+                //
+                //  Consumers run at different speeds.
+                //
+                Delay(Ticks::MsToTicks(Index + 1));
+
+                if (++count >= 500) {
+                    count = 0;
+                    cout << GetName() << " received 500 frames" << endl;
+                }
+            }
+        };
+
+    private:
+        int Index;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "SharedBuffer Testing" << endl;
+
+    framePool = new MemoryPool(SharedBuffer::HeaderSize + FRAME_SIZE, 
+                               NUM_FRAMES, 
+                               2 * sizeof(void *));
+
+    for (int i = 0; i < NUM_CONSUMERS; i++) {
+        frameQueues[i] = new Queue(NUM_FRAMES, sizeof(void *));
+    }
+
+    SensorThread sensor;
+    ConsumerThread consumer1("consumer_1", 0);
+    ConsumerThread consumer2("consumer_2", 1);
+    ConsumerThread consumer3("consumer_3", 2);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
@@ -0,0 +1,201 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <list>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "size_class_allocator.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+//
+//  How many items in each size class, 16 through 256 bytes.
+//
+static const int ClassCounts[SizeClassAllocator::NumSizeClasses] = {
+    64, 64, 32, 16, 8
+};
+
+
+//
+//  Objects of assorted sizes, all of which now come out of the
+//  size class pools through the global operator new.
+//
+template<int SIZE>
+class Blob {
+    public:
+        explicit Blob(unsigned char pattern)
+            : Pattern(pattern)
+        {
+            memset(Data, pattern, SIZE);
+        }
+
+        void Verify()
+        {
+            for (int i = 0; i < SIZE; i++) {
+                configASSERT(Data[i] == Pattern);
+            }
+        }
+
+    private:
+        unsigned char Pattern;
+        unsigned char Data[SIZE];
+};
+
+
+class TestThread : public Thread {
+
+    public:
+
+        TestThread(string name, unsigned char pattern)
+           : Thread(name, 1000, 1),
+             Pattern(pattern)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            int run_cnt = 0;
+
+            while (true) {
+
+                Blob<8> *small = new Blob<8>(Pattern);
+                Blob<40> *medium = new Blob<40>(Pattern);
+                Blob<200> *large = new Blob<200>(Pattern);
+                Blob<1000> *huge = new Blob<1000>(Pattern);
+
+                list<int> numbers;
+                for (int i = 0; i < 10; i++) {
+                    numbers.push_back(i);
+                }
+
+                string message = GetName() + " is allocating from size classes";
+
+                Delay(Ticks::MsToTicks(Pattern));
+
+                small->Verify();
+                medium->Verify();
+                large->Verify();
+                huge->Verify();
+
+                delete small;
+                delete medium;
+                delete large;
+                delete huge;
+
+                if (run_cnt++ > 100) {
+                    run_cnt = 0;
+                    cout << message << endl;
+                }
+            }
+        };
+
+    private:
+        unsigned char Pattern;
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "SizeClassAllocator Testing" << endl;
+
+    //
+    //  Everything allocated before this point came from the system 
+    //  heap, everything after from the size class pools.
+    //
+    SizeClassAllocator::Install(new SizeClassAllocator(ClassCounts));
+
+    TestThread thread1("Thread_1", 1);
+    TestThread thread2("Thread_2", 3);
+    TestThread thread3("Thread_3", 5);
+    TestThread thread4("Thread_4", 7);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
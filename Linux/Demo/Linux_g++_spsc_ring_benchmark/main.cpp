@@ -0,0 +1,282 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "queue.hpp"
+#include "spsc_ring.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define RING_SIZE               64
+#define ITEMS_PER_RUN           200000
+
+
+//
+//  Global, so the cache line alignment doesn't depend on operator new.
+//
+SpscRing<uint32_t, RING_SIZE> ring;
+Queue *queue;
+
+
+//
+//  Adapters so the same producer / consumer pair can drive either one.
+//
+class ChannelAdapter {
+    public:
+        virtual void Send(uint32_t item) = 0;
+        virtual uint32_t Receive() = 0;
+        virtual const char *Name() = 0;
+        virtual ~ChannelAdapter() {}
+};
+
+
+class QueueAdapter : public ChannelAdapter {
+    public:
+        virtual void Send(uint32_t item) { queue->Enqueue(&item); }
+        virtual uint32_t Receive() { 
+            uint32_t item;
+            queue->Dequeue(&item);
+            return item;
+        }
+        virtual const char *Name() { return "Queue"; }
+};
+
+
+class RingAdapter : public ChannelAdapter {
+    public:
+        virtual void Send(uint32_t item) {
+            //
+            //  The producer side never blocks, let the consumer drain.
+            //
+            while (!ring.Push(item)) {
+                taskYIELD();
+            }
+        }
+        virtual uint32_t Receive() {
+            uint32_t item;
+            ring.Pop(item, portMAX_DELAY);
+            return item;
+        }
+        virtual const char *Name() { return "SpscRing"; }
+};
+
+
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread(ChannelAdapter *channel)
+           : Thread("producer", 1000, 2),
+             Done(false),
+             Channel(channel)
+        {
+            Start();
+        };
+
+        volatile bool Done;
+
+    protected:
+
+        virtual void Run() {
+
+            for (uint32_t i = 0; i < ITEMS_PER_RUN; i++) {
+                Channel->Send(i);
+            }
+
+            Done = true;
+
+            while (true) {
+                Delay(Ticks::SecondsToTicks(10));
+            }
+        };
+
+    private:
+        ChannelAdapter *Channel;
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread(ChannelAdapter *channel)
+           : Thread("consumer", 1000, 2),
+             Done(false),
+             OutOfOrder(0),
+             Channel(channel)
+        {
+            Start();
+        };
+
+        volatile bool Done;
+        unsigned long OutOfOrder;
+
+    protected:
+
+        virtual void Run() {
+
+            for (uint32_t i = 0; i < ITEMS_PER_RUN; i++) {
+                if (Channel->Receive() != i) {
+                    OutOfOrder++;
+                }
+            }
+
+            Done = true;
+
+            while (true) {
+                Delay(Ticks::SecondsToTicks(10));
+            }
+        };
+
+    private:
+        ChannelAdapter *Channel;
+};
+
+
+class ControlThread : public Thread {
+
+    public:
+
+        ControlThread()
+           : Thread("control", 1000, 3)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            QueueAdapter queueAdapter;
+            RingAdapter ringAdapter;
+
+            while (true) {
+                RunBenchmark(&queueAdapter);
+                RunBenchmark(&ringAdapter);
+                Delay(Ticks::SecondsToTicks(1));
+            }
+        };
+
+    private:
+
+        void RunBenchmark(ChannelAdapter *channel) {
+
+            TickType_t start = Ticks::GetTicks();
+
+            ConsumerThread *consumer = new ConsumerThread(channel);
+            ProducerThread *producer = new ProducerThread(channel);
+
+            while (!producer->Done || !consumer->Done) {
+                Delay(1);
+            }
+
+            TickType_t elapsed = Ticks::GetTicks() - start;
+            if (elapsed == 0) {
+                elapsed = 1;
+            }
+
+            cout << channel->Name() << ": "
+                 << ITEMS_PER_RUN << " items in " << Ticks::TicksToMs(elapsed) << " ms = "
+                 << (ITEMS_PER_RUN * 1000ULL) / Ticks::TicksToMs(elapsed) << " items/sec ("
+                 << consumer->OutOfOrder << " out of order)" << endl;
+
+            delete producer;
+            delete consumer;
+        }
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "Queue vs SpscRing benchmark" << endl;
+
+    queue = new Queue(RING_SIZE, sizeof(uint32_t));
+
+    ControlThread control;
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
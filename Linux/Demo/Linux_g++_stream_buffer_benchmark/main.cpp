@@ -0,0 +1,402 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "semaphore.hpp"
+#include "typed_queue.hpp"
+#include "stream_buffer.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+//
+//  A UART receive path. The receive "ISR" hands over each burst as it 
+//  comes off the wire, and after every few bursts the line goes idle 
+//  for a tick. The protocol task wants to wake up as rarely as it can, 
+//  without leaving the end of a burst sitting in the buffer for long.
+//
+//  That is exactly the stream buffer trigger level trade off. A low 
+//  trigger level wakes the reader for nearly every burst, a high one 
+//  batches bursts up, but then whatever is left below the trigger 
+//  level when the line goes idle waits for the reader's idle timeout.
+//  Each run counts wake ups, and how many reads were only released by
+//  the idle timeout, for a range of trigger levels set on the same 
+//  StreamBuffer with SetTriggerLevel(). A TypedQueue<uint8_t> run, 
+//  where every byte is a separate queue item, and a MessageBuffer run, 
+//  where every burst is read as one message, are the comparisons.
+//
+#define BUFFER_SIZE             256
+#define READ_SIZE               128
+#define IDLE_TIMEOUT_MS         5
+#define BURSTS_PER_RUN          2000
+#define BURSTS_PER_IDLE         4
+
+
+static const size_t BurstSizes[] = { 1, 5, 12, 24, 48, 100 };
+#define NUM_BURST_SIZES         (sizeof(BurstSizes) / sizeof(BurstSizes[0]))
+
+static const size_t TriggerLevels[] = { 1, 8, 32, 64, 128 };
+#define NUM_TRIGGER_LEVELS      (sizeof(TriggerLevels) / sizeof(TriggerLevels[0]))
+
+
+enum Channel {
+    ByteQueue,
+    Stream,
+    Message
+};
+
+
+TypedQueue<uint8_t> *byteQueue;
+StreamBuffer *streamBuffer;
+MessageBuffer *messageBuffer;
+
+
+//
+//  What the current run uses, set by the control thread before it 
+//  starts the run.
+//
+Channel currentChannel;
+size_t currentTriggerLevel;
+
+BinarySemaphore *startRx;
+BinarySemaphore *startProtocol;
+CountingSemaphore *runDone;
+
+
+static size_t BytesPerRun()
+{
+    size_t total = 0;
+
+    for (int i = 0; i < BURSTS_PER_RUN; i++) {
+        total += BurstSizes[i % NUM_BURST_SIZES];
+    }
+
+    return total;
+}
+
+
+class UartRxThread : public Thread {
+
+    public:
+
+        UartRxThread()
+           : Thread("uart rx", 1000, 3)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            uint8_t burst[BUFFER_SIZE];
+
+            while (true) {
+
+                startRx->Take();
+
+                uint8_t next = 0;
+
+                for (int i = 0; i < BURSTS_PER_RUN; i++) {
+
+                    size_t length = BurstSizes[i % NUM_BURST_SIZES];
+
+                    for (size_t j = 0; j < length; j++) {
+                        burst[j] = next++;
+                    }
+
+                    switch (currentChannel) {
+                        case ByteQueue:
+                            byteQueue->EnqueueMany(burst, length);
+                            break;
+                        case Stream:
+                            streamBuffer->Send(burst, length);
+                            break;
+                        case Message:
+                            messageBuffer->Send(burst, length);
+                            break;
+                    }
+
+                    if ((i + 1) % BURSTS_PER_IDLE == 0) {
+                        Delay(1);
+                    }
+                }
+
+                runDone->Give();
+            }
+        };
+};
+
+
+class ProtocolThread : public Thread {
+
+    public:
+
+        ProtocolThread()
+           : Thread("protocol", 1000, 2),
+             WakeUps(0),
+             IdleReads(0),
+             Corrupt(0)
+        {
+            Start();
+        };
+
+        unsigned long WakeUps;
+        unsigned long IdleReads;
+        unsigned long Corrupt;
+
+    protected:
+
+        virtual void Run() {
+
+            uint8_t data[READ_SIZE];
+            TickType_t idleTimeout = Ticks::MsToTicks(IDLE_TIMEOUT_MS);
+
+            while (true) {
+
+                startProtocol->Take();
+
+                WakeUps = 0;
+                IdleReads = 0;
+                Corrupt = 0;
+
+                uint8_t expected = 0;
+                size_t messages = 0;
+                size_t total = BytesPerRun();
+
+                for (size_t received = 0; received < total; ) {
+
+                    size_t n = 0;
+
+                    switch (currentChannel) {
+                        case ByteQueue:
+                            n = byteQueue->DequeueMany(data, READ_SIZE, idleTimeout);
+                            break;
+
+                        case Stream:
+                            n = streamBuffer->Receive(data, READ_SIZE, idleTimeout);
+                            //
+                            //  Less than the trigger level means the idle
+                            //  timeout let it through, not the trigger.
+                            //
+                            if (n > 0 && n < currentTriggerLevel) {
+                                IdleReads++;
+                            }
+                            break;
+
+                        case Message:
+                            n = messageBuffer->Receive(data, READ_SIZE, idleTimeout);
+                            //
+                            //  Each message has to be a whole burst.
+                            //
+                            if (n > 0 && n != BurstSizes[messages++ % NUM_BURST_SIZES]) {
+                                Corrupt++;
+                            }
+                            break;
+                    }
+
+                    if (n == 0) {
+                        continue;
+                    }
+
+                    for (size_t i = 0; i < n; i++) {
+                        if (data[i] != expected++) {
+                            Corrupt++;
+                        }
+                    }
+
+                    received += n;
+                    WakeUps++;
+                }
+
+                runDone->Give();
+            }
+        };
+};
+
+
+class ControlThread : public Thread {
+
+    public:
+
+        ControlThread(ProtocolThread *protocol)
+           : Thread("control", 1000, 1),
+             Protocol(protocol)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            //
+            //  The trigger level can't be more than the buffer holds.
+            //
+            cout << "SetTriggerLevel(" << BUFFER_SIZE + 1 << ") "
+                 << (streamBuffer->SetTriggerLevel(BUFFER_SIZE + 1) ? "accepted" : "rejected")
+                 << endl;
+
+            while (true) {
+
+                RunBenchmark(ByteQueue, 1, "TypedQueue<uint8_t>");
+
+                for (size_t i = 0; i < NUM_TRIGGER_LEVELS; i++) {
+
+                    streamBuffer->Reset();
+
+                    if (!streamBuffer->SetTriggerLevel(TriggerLevels[i])) {
+                        cout << "SetTriggerLevel(" << TriggerLevels[i] << ") failed" << endl;
+                        continue;
+                    }
+
+                    RunBenchmark(Stream, TriggerLevels[i], "StreamBuffer");
+                }
+
+                RunBenchmark(Message, 1, "MessageBuffer");
+
+                Delay(Ticks::SecondsToTicks(1));
+            }
+        };
+
+    private:
+
+        ProtocolThread *Protocol;
+
+        void RunBenchmark(Channel channel, size_t triggerLevel, const char *name) {
+
+            currentChannel = channel;
+            currentTriggerLevel = triggerLevel;
+
+            TickType_t start = Ticks::GetTicks();
+
+            startProtocol->Give();
+            startRx->Give();
+
+            runDone->Take();
+            runDone->Take();
+
+            TickType_t elapsed = Ticks::GetTicks() - start;
+            if (elapsed == 0) {
+                elapsed = 1;
+            }
+
+            size_t total = BytesPerRun();
+            unsigned long wakeUps = Protocol->WakeUps ? Protocol->WakeUps : 1;
+
+            cout << name;
+            if (channel == Stream) {
+                cout << " trigger " << triggerLevel;
+            }
+            cout << ": " << total << " bytes in " << Ticks::TicksToMs(elapsed) << " ms, "
+                 << Protocol->WakeUps << " wake ups, "
+                 << total / wakeUps << " bytes per wake up, ";
+            if (channel == Stream) {
+                cout << Protocol->IdleReads << " released by idle timeout, ";
+            }
+            cout << Protocol->Corrupt << " corrupt" << endl;
+        }
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "StreamBuffer trigger level vs TypedQueue<uint8_t> vs MessageBuffer benchmark" << endl;
+
+    byteQueue = new TypedQueue<uint8_t>(BUFFER_SIZE);
+    streamBuffer = new StreamBuffer(BUFFER_SIZE);
+    messageBuffer = new MessageBuffer(BUFFER_SIZE);
+
+    startRx = new BinarySemaphore();
+    startProtocol = new BinarySemaphore();
+    runDone = new CountingSemaphore(2, 0);
+
+    UartRxThread rx;
+    ProtocolThread protocol;
+    ControlThread control(&protocol);
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
+
@@ -0,0 +1,219 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "thread.hpp"
+#include "ticks.hpp"
+#include "zero_copy_queue.hpp"
+
+
+using namespace cpp_freertos;
+using namespace std;
+
+
+#define NUM_MESSAGES    8
+#define PAYLOAD_SIZE    64
+
+
+//
+//  Big enough that copying it through a regular queue would hurt.
+//
+class Message {
+
+    public:
+
+        Message(int sequence, unsigned char fill)
+            : Sequence(sequence)
+        {
+            for (int i = 0; i < PAYLOAD_SIZE; i++) {
+                Payload[i] = fill;
+            }
+        }
+
+        ~Message()
+        {
+            Sequence = -1;
+        }
+
+        int Sequence;
+        unsigned char Payload[PAYLOAD_SIZE];
+};
+
+
+ZeroCopyQueue<Message> *messageQueue;
+
+
+class ProducerThread : public Thread {
+
+    public:
+
+        ProducerThread()
+           : Thread("producer", 1000, 2)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            int sequence = 0;
+
+            while (true) {
+
+                //
+                //  Built directly in pool memory, blocks until the 
+                //  consumer has finished with an older message.
+                //
+                ZeroCopyQueue<Message>::Item item = 
+                    messageQueue->EmplaceWithTimeout(portMAX_DELAY, 
+                                                     sequence, 
+                                                     (unsigned char)sequence);
+                configASSERT(item.Get() != NULL);
+
+                //
+                //  Every fourth message is dropped before it is sent,
+                //  the handle hands it back to the pool for us.
+                //
+                if (sequence++ % 4 == 3) {
+                    continue;
+                }
+
+                messageQueue->Enqueue(item);
+            }
+        };
+};
+
+
+class ConsumerThread : public Thread {
+
+    public:
+
+        ConsumerThread()
+           : Thread("consumer", 1000, 1)
+        {
+            Start();
+        };
+
+    protected:
+
+        virtual void Run() {
+
+            int expected = 0;
+            int count = 0;
+
+            while (true) {
+
+                ZeroCopyQueue<Message>::Item item = messageQueue->Dequeue();
+                configASSERT(item.Get() != NULL);
+
+                if (expected % 4 == 3) {
+                    expected++;
+                }
+
+                configASSERT(item->Sequence == expected);
+                for (int i = 0; i < PAYLOAD_SIZE; i++) {
+                    configASSERT(item->Payload[i] == (unsigned char)expected);
+                }
+                expected++;
+
+                Delay(Ticks::MsToTicks(1));
+
+                if (++count >= 500) {
+                    count = 0;
+                    cout << "consumer received 500 messages" << endl;
+                }
+            }
+        };
+};
+
+
+int main (void)
+{
+    cout << "Testing FreeRTOS C++ wrappers" << endl;
+    cout << "ZeroCopyQueue Testing" << endl;
+
+    messageQueue = new ZeroCopyQueue<Message>(NUM_MESSAGES);
+
+    ProducerThread producer;
+    ConsumerThread consumer;
+
+    Thread::StartScheduler();
+
+    //
+    //  We shouldn't ever get here unless someone calls 
+    //  Thread::EndScheduler()
+    //
+
+    cout << "Scheduler ended!" << endl;
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+extern "C" void vApplicationMallocFailedHook(void);
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
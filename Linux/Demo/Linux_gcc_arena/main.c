@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_pool.h"
+#include "arena.h"
+
+
+
+/**
+ *  A short lived record, built up during one processing cycle.
+ */
+typedef struct Record_t_ {
+
+    struct Record_t_ *Next;
+    int Length;
+    unsigned char Data[1];
+
+} Record_t;
+
+
+#define ARENA_SIZE      4096
+#define NUM_ARENAS      2
+
+
+MemoryPool_t arenaPool;
+
+
+/**
+ *  Build a list of variable sized records in the Arena, 
+ *  then check them.
+ */
+int BuildAndCheck(Arena_t arena, int Cycle)
+{
+    Record_t *Head = NULL;
+    Record_t *Record;
+    int Length;
+    int Count = 0;
+    int i;
+
+    while (1) {
+
+        Length = 1 + ((Cycle + Count) % 60);
+
+        Record = (Record_t *)ArenaAllocate( arena, 
+                                            sizeof(Record_t) + Length,
+                                            ARENA_DEFAULT_ALIGNMENT);
+        if (Record == NULL) {
+            break;
+        }
+
+        configASSERT(((uintptr_t)Record & (ARENA_DEFAULT_ALIGNMENT - 1)) == 0);
+
+        Record->Length = Length;
+        memset(Record->Data, Length, Length);
+        Record->Next = Head;
+        Head = Record;
+        Count++;
+    }
+
+    for (Record = Head; Record != NULL; Record = Record->Next) {
+        for (i = 0; i < Record->Length; i++) {
+            configASSERT(Record->Data[i] == (unsigned char)Record->Length);
+        }
+    }
+
+    return Count;
+}
+
+
+void TestThread(void *parameters)
+{
+    Arena_t arena;
+    int Cycle = 0;
+    int Marker;
+    int Count;
+    void *Header;
+
+    (void)parameters;
+
+    /*  Each task borrows its own Arena region from a shared pool. */
+    arena = CreateArenaFromPool(arenaPool);
+    configASSERT(arena != NULL);
+
+    while(1) {
+
+        /*  Something that lives for the whole cycle. */
+        Header = ArenaAllocate(arena, 100, 1);
+        configASSERT(Header != NULL);
+        memset(Header, 0x5A, 100);
+
+        /*  A nested scope, thrown away before the cycle ends. */
+        Marker = ArenaGetMarker(arena);
+        Count = BuildAndCheck(arena, Cycle);
+        ArenaResetToMarker(arena, Marker);
+
+        configASSERT(ArenaGetBytesUsed(arena) == Marker);
+        configASSERT(((unsigned char *)Header)[99] == 0x5A);
+
+        /*  End of cycle, free everything at once. */
+        ArenaReset(arena);
+        configASSERT(ArenaGetBytesFree(arena) >= ARENA_SIZE);
+
+        if (++Cycle % 100 == 0) {
+            printf("%d cycles, %d records in the last one\n", Cycle, Count);
+        }
+
+        vTaskDelay(1);
+    }
+
+    configASSERT(!"CANNOT EXIT FROM A TASK");
+}
+
+
+int main (void)
+{
+    BaseType_t rc;
+    int i;
+
+    printf("Testing arenas\n");
+
+    arenaPool = CreateMemoryPool(ARENA_SIZE, NUM_ARENAS, 16);
+    configASSERT(arenaPool != NULL);
+
+    for (i = 0; i < NUM_ARENAS; i++) {
+        rc = xTaskCreate(   TestThread, 
+                            "test",
+                            1000,
+                            NULL,
+                            3,
+                            NULL);
+        /**
+         *  Make sure out task was created.
+         */
+        configASSERT(rc == pdPASS);
+    }
+
+    /**
+     *  Start FreeRTOS here.
+     */
+    vTaskStartScheduler();
+
+    /*
+     *  We shouldn't ever get here unless someone calls 
+     *  vTaskEndScheduler(). Note that there appears to be a 
+     *  bug in the Linux FreeRTOS simulator that crashes when
+     *  this is called.
+     */
+    printf("Scheduler ended!\n");
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
@@ -125,6 +125,20 @@ MemoryPool_t pool_9;
 
 
 
+void PrintPoolStats(const char *name, MemoryPool_t p)
+{
+    MemoryPoolStats_t stats;
+
+    MemoryPoolGetStats(p, &stats);
+
+    printf("%s: %d/%d free, low water %d, peak %d, "
+           "%lu allocs, %lu frees, %lu failed\n",
+           name, stats.FreeItems, stats.TotalItems, stats.LowWaterMark,
+           stats.PeakUsage, stats.Allocations, stats.Frees, 
+           stats.FailedAllocations);
+}
+
+
 void TestThread(void *parameters)
 {
     ThreadParameters_t *tp;
@@ -153,6 +167,7 @@ void TestThread(void *parameters)
         printf("running thread %d ...\n", tp->DelayInSeconds);
         TotalRuns++;
         if (TotalRuns > 20) {
+            PrintPoolStats("pool_1", pool_1);
             while (1) {
                 vTaskDelay(10000);
             }
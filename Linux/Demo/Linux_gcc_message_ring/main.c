@@ -0,0 +1,204 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "message_ring.h"
+
+
+
+#define RING_SIZE       2048
+#define MAX_LINE        200
+
+
+MessageRing_t logRing;
+
+
+/**
+ *  Write log lines of varying length straight into the ring.
+ */
+void LoggerThread(void *parameters)
+{
+    char *Line;
+    int Length;
+    int Sequence = 0;
+
+    (void)parameters;
+
+    printf("Logger Thread starting...\n");
+
+    while(1) {
+
+        /*  Reserve for the worst case, commit what we actually used. */
+        Line = (char *)MessageRingReserve(logRing, MAX_LINE, portMAX_DELAY);
+        configASSERT(Line != NULL);
+
+        Length = snprintf(  Line, MAX_LINE, 
+                            "log %d: %.*s", 
+                            Sequence, 
+                            Sequence % 150, 
+                            "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+                            "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+                            "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+
+        MessageRingCommit(logRing, Length + 1);
+
+        Sequence++;
+
+        if (Sequence % 8 == 0) {
+            vTaskDelay(1);
+        }
+    }
+
+    configASSERT(!"CANNOT EXIT FROM A TASK");
+}
+
+
+/**
+ *  Read the log lines in place.
+ */
+void WriterThread(void *parameters)
+{
+    char *Line;
+    int Length;
+    int Sequence;
+    int Expected = 0;
+
+    (void)parameters;
+
+    printf("Writer Thread starting...\n");
+
+    while(1) {
+
+        Line = (char *)MessageRingPeek(logRing, &Length, 10000);
+        configASSERT(Line != NULL);
+
+        configASSERT(Length == (int)strlen(Line) + 1);
+        configASSERT(sscanf(Line, "log %d:", &Sequence) == 1);
+        configASSERT(Sequence == Expected);
+
+        if (Sequence % 1000 == 0) {
+            printf("%s\n", Line);
+        }
+
+        MessageRingRelease(logRing);
+
+        Expected++;
+    }
+
+    configASSERT(!"CANNOT EXIT FROM A TASK");
+}
+
+
+int main (void)
+{
+    BaseType_t rc;
+
+    printf("Testing message rings\n");
+
+    logRing = CreateMessageRing(RING_SIZE);
+    configASSERT(logRing != NULL);
+
+    rc = xTaskCreate(   LoggerThread, 
+                        "logger",
+                        1000,
+                        NULL,
+                        3,
+                        NULL);
+    /**
+     *  Make sure out task was created.
+     */
+    configASSERT(rc == pdPASS);
+
+    rc = xTaskCreate(   WriterThread, 
+                        "writer",
+                        1000,
+                        NULL,
+                        2,
+                        NULL);
+    /**
+     *  Make sure out task was created.
+     */
+    configASSERT(rc == pdPASS);
+
+    /**
+     *  Start FreeRTOS here.
+     */
+    vTaskStartScheduler();
+
+    /*
+     *  We shouldn't ever get here unless someone calls 
+     *  vTaskEndScheduler(). Note that there appears to be a 
+     *  bug in the Linux FreeRTOS simulator that crashes when
+     *  this is called.
+     */
+    printf("Scheduler ended!\n");
+
+    return 0;
+}
+
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+    printf("ASSERT: %s : %d\n", pcFileName, (int)ulLine);
+    while(1);
+}
+
+
+unsigned long ulGetRunTimeCounterValue(void)
+{
+    return 0;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+    return;
+}
+
+
+void vApplicationMallocFailedHook(void)
+{
+	while(1);
+}
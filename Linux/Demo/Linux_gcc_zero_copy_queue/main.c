@@ -57,6 +57,7 @@ typedef struct TestData_t_ {
 
 
 #define TEST_DATA_COUNT 25
+#define BURST_SIZE 8
 
 
 void CreateTestData(TestData_t *td, int start)
@@ -85,8 +86,10 @@ ZeroCopyQueue_t ZcQueue_1;
 void SendTestThread(void *parameters)
 {
     (void)parameters;
-    TestData_t *td;
+    TestData_t *burst[BURST_SIZE];
+    int burstSize;
     int i = 0;
+    int j;
     int rc;
 
     printf("Sending Thread starting...\n");
@@ -94,19 +97,33 @@ void SendTestThread(void *parameters)
 
     while(1) {
 
-        td = (TestData_t *)ZcqAllocateItem(ZcQueue_1);
-        if (td == NULL) {
-            vTaskDelay(1000);
-            td = (TestData_t *)ZcqAllocateItem(ZcQueue_1);
-            configASSERT(td != NULL);
+        /**
+         *  Alternate between single items and bursts, the 
+         *  receiver has to cope with both.
+         */
+        burstSize = (i % 2) ? BURST_SIZE : 1;
+
+        for (j = 0; j < burstSize; j++) {
+
+            burst[j] = (TestData_t *)ZcqAllocateItem(ZcQueue_1);
+            if (burst[j] == NULL) {
+                vTaskDelay(1000);
+                burst[j] = (TestData_t *)ZcqAllocateItem(ZcQueue_1);
+                configASSERT(burst[j] != NULL);
+            }
+            CreateTestData(burst[j], i + j);
         }
-        CreateTestData(td, i);
 
-        rc = ZcqEnqueueItem(ZcQueue_1, td, 1000);
-
-        configASSERT(rc == 1);
+        if (burstSize == 1) {
+            rc = ZcqEnqueueItem(ZcQueue_1, burst[0], 1000);
+            configASSERT(rc == 1);
+        }
+        else {
+            rc = ZcqEnqueueBatch(ZcQueue_1, (void **)burst, burstSize, 1000);
+            configASSERT(rc == burstSize);
+        }
     
-        i++;
+        i += burstSize;
 
         vTaskDelay(1);
 
@@ -123,28 +140,36 @@ void SendTestThread(void *parameters)
 void ReceiveTestThread(void *parameters)
 {
     (void)parameters;
-    TestData_t *td;
+    TestData_t *burst[BURST_SIZE];
+    int count;
     int i = 0;
+    int j;
     int rc;
 
     printf("Receiving Thread starting...\n");
 
     while(1) {
 
-        td = ZcqDequeueItem(ZcQueue_1, 10000);
+        /**
+         *  One wake up drains everything that's waiting.
+         */
+        count = ZcqDequeueBatch(ZcQueue_1, (void **)burst, BURST_SIZE, 10000);
         
-        configASSERT(td != NULL);
+        configASSERT(count > 0);
 
-        rc = VerifyTestData(td, i);
+        for (j = 0; j < count; j++) {
+
+            rc = VerifyTestData(burst[j], i);
         
-        configASSERT(rc == 1);
+            configASSERT(rc == 1);
 
-        ZcqFreeItem(ZcQueue_1, td);
+            ZcqFreeItem(ZcQueue_1, burst[j]);
 
-        i++;
+            i++;
 
-        if (i % 1000 == 0)
-            printf("%d messages received ok\n", i);
+            if (i % 1000 == 0)
+                printf("%d messages received ok\n", i);
+        }
 
         if (i > 10000){
             printf("%d messages received ok - Done\n", i);
@@ -0,0 +1,114 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdlib.h>
+#include "arena.hpp"
+
+
+using namespace cpp_freertos;
+
+
+Arena::Arena(int size)
+    : Buffer(NULL),
+      Size(size),
+      Offset(0),
+      Source(FromMalloc),
+      Pool(NULL)
+{
+    Buffer = (unsigned char *)malloc(size);
+
+    if (Buffer == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw ArenaCreateException();
+#else
+        configASSERT(!"Arena malloc Failed");
+#endif
+    }
+}
+
+
+Arena::Arena(void *buffer, int size)
+    : Buffer((unsigned char *)buffer),
+      Size(size),
+      Offset(0),
+      Source(FromCaller),
+      Pool(NULL)
+{
+}
+
+
+Arena::Arena(MemoryPool &pool)
+    : Buffer(NULL),
+      Size(pool.GetItemSize()),
+      Offset(0),
+      Source(FromPool),
+      Pool(&pool)
+{
+    Buffer = (unsigned char *)pool.Allocate();
+
+    if (Buffer == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw ArenaCreateException();
+#else
+        configASSERT(!"Arena MemoryPool empty");
+#endif
+    }
+}
+
+
+Arena::~Arena()
+{
+    if (Source == FromMalloc) {
+        free(Buffer);
+    }
+    else if (Source == FromPool) {
+        Pool->Free(Buffer);
+    }
+}
+
+
+void Arena::ResetToMarker(Marker marker)
+{
+    configASSERT(marker >= 0 && marker <= Offset);
+
+    Offset = marker;
+}
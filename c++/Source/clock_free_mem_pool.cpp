@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+
+
+#include <stdlib.h>
+#include "lock_free_mem_pool.hpp"
+
+
+using namespace cpp_freertos;
+
+
+//
+//  The top of the free stack is a single word, the index in the 
+//  low half, the tag in the high half.
+//
+#define LF_INDEX_BITS   (sizeof(uintptr_t) * 4)
+#define LF_INDEX_MASK   ((((uintptr_t)1) << LF_INDEX_BITS) - 1)
+#define LF_TAG_ONE      (((uintptr_t)1) << LF_INDEX_BITS)
+
+
+void LockFreeMemoryPool::CalculateValidAlignment()
+{
+    /**
+     *  Guarantee that the alignment is the size of a pointer.
+     */
+    if (Alignment < (int)sizeof(unsigned char *)) {
+        Alignment = (int)sizeof(unsigned char *);
+    }
+
+    int alignmentBit = 0x1;
+    int i;
+
+    for (i = 0; i < 31; i++) {
+        if (Alignment == alignmentBit) {
+            break;
+        }
+        alignmentBit <<= 1;
+    }
+
+    if (i >= 31) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MemoryPoolBadAlignmentException();
+#else
+        configASSERT(!"MemoryPool Bad Alignment");
+#endif
+    }
+}
+
+
+void LockFreeMemoryPool::CalculateItemSize()
+{
+    if (ItemSize <= Alignment) {
+
+        ItemSize = Alignment;
+    }
+    else {
+
+        int alignmentCount = ItemSize / Alignment;
+        if (ItemSize % Alignment != 0) {
+            alignmentCount++;
+        }
+
+        ItemSize = alignmentCount * Alignment;
+    }
+}
+
+
+void LockFreeMemoryPool::ValidateItemCount(int itemCount)
+{
+    if (itemCount < 0 || (uintptr_t)itemCount >= LF_INDEX_MASK) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MemoryPoolTooManyItemsException();
+#else
+        configASSERT(!"MemoryPool Too Many Items");
+#endif
+    }
+}
+
+
+void LockFreeMemoryPool::InitItems(int itemCount)
+{
+    //
+    //  Item i links to item i + 1, the last one links to "empty".
+    //
+    for (int i = 0; i < itemCount; i++) {
+        *(uintptr_t *)(Buffer + (i * ItemSize)) =
+            (i + 1 < itemCount) ? (uintptr_t)(i + 2) : 0;
+    }
+
+    Top = (itemCount > 0) ? 1 : 0;
+}
+
+
+LockFreeMemoryPool::LockFreeMemoryPool( int itemSize,
+                                        int itemCount,
+                                        int alignment)
+    : Top(0),
+      Buffer(NULL),
+      ItemSize(itemSize),
+      Alignment(alignment)
+{
+    CalculateValidAlignment();
+
+    CalculateItemSize();
+
+    ValidateItemCount(itemCount);
+
+    //
+    //  Over allocate so we can align the first item.
+    //
+    unsigned char *address = 
+        (unsigned char *)malloc((ItemSize * itemCount) + Alignment);
+
+    if (address == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MemoryPoolMallocException();
+#else
+        configASSERT(!"MemoryPool malloc Failed");
+#endif
+    }
+
+    Buffer = (unsigned char *)
+        (((uintptr_t)address + Alignment - 1) & ~((uintptr_t)Alignment - 1));
+
+    InitItems(itemCount);
+}
+
+
+LockFreeMemoryPool::LockFreeMemoryPool( int itemSize,
+                                        void *preallocatedMemory,
+                                        int preallocatedMemorySize,
+                                        int alignment)
+    : Top(0),
+      Buffer(NULL),
+      ItemSize(itemSize),
+      Alignment(alignment)
+{
+    CalculateValidAlignment();
+
+    CalculateItemSize();
+
+    unsigned char *address = (unsigned char *)preallocatedMemory;
+
+    Buffer = (unsigned char *)
+        (((uintptr_t)address + Alignment - 1) & ~((uintptr_t)Alignment - 1));
+
+    preallocatedMemorySize -= (int)(Buffer - address);
+
+    int itemCount = preallocatedMemorySize > 0 ? 
+                        preallocatedMemorySize / ItemSize : 0;
+
+    ValidateItemCount(itemCount);
+
+    InitItems(itemCount);
+}
+
+
+void *LockFreeMemoryPool::Allocate()
+{
+    uintptr_t oldTop = __atomic_load_n(&Top, __ATOMIC_ACQUIRE);
+    uintptr_t newTop;
+    unsigned char *item;
+
+    do {
+        if ((oldTop & LF_INDEX_MASK) == 0)
+            return NULL;
+
+        item = Buffer + (((oldTop & LF_INDEX_MASK) - 1) * ItemSize);
+
+        //
+        //  If someone else pops this item first, next may be stale,
+        //  but then the tag has changed and the exchange will fail.
+        //
+        uintptr_t next = __atomic_load_n((uintptr_t *)item, __ATOMIC_RELAXED);
+
+        newTop = ((oldTop & ~LF_INDEX_MASK) + LF_TAG_ONE) | next;
+
+    } while (!__atomic_compare_exchange_n(  &Top,
+                                            &oldTop,
+                                            newTop,
+                                            true,
+                                            __ATOMIC_ACQUIRE,
+                                            __ATOMIC_ACQUIRE));
+
+    return item;
+}
+
+
+void LockFreeMemoryPool::Free(void *item)
+{
+    uintptr_t index = 
+        (uintptr_t)(((unsigned char *)item - Buffer) / ItemSize) + 1;
+    uintptr_t oldTop = __atomic_load_n(&Top, __ATOMIC_RELAXED);
+    uintptr_t newTop;
+
+    do {
+        __atomic_store_n((uintptr_t *)item, oldTop & LF_INDEX_MASK, 
+                         __ATOMIC_RELAXED);
+
+        newTop = ((oldTop & ~LF_INDEX_MASK) + LF_TAG_ONE) | index;
+
+    } while (!__atomic_compare_exchange_n(  &Top,
+                                            &oldTop,
+                                            newTop,
+                                            true,
+                                            __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED));
+}
+
@@ -49,6 +49,13 @@
 using namespace cpp_freertos;
 
 
+/**
+ *  The wake up semaphore is never given more times than there are
+ *  blocked tasks, so any limit comfortably above the task count works.
+ */
+#define MAX_WAITERS     0x7FFF
+
+
 void MemoryPool::CalculateValidAlignment()
 {
     /**
@@ -100,12 +107,27 @@ MemoryPool::MemoryPool( int itemSize,
                         int itemCount,
                         int alignment)
     : ItemSize(itemSize),
-      Alignment(alignment)
+      Alignment(alignment),
+      FreeItems(NULL),
+      ItemFreed(NULL),
+      Waiters(0)
 {
+    StatsInit();
+
     CalculateValidAlignment();
 
     CalculateItemSize();
 
+    ItemFreed = xSemaphoreCreateCounting(MAX_WAITERS, 0);
+
+    if (ItemFreed == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MemoryPoolMallocException();
+#else
+        configASSERT(!"MemoryPool semaphore create Failed");
+#endif
+    }
+
     unsigned char *address = (unsigned char *)malloc(ItemSize * itemCount);
 
     if (address == NULL) {
@@ -116,12 +138,7 @@ MemoryPool::MemoryPool( int itemSize,
 #endif
     }
 
-    for (int i = 0; i < itemCount; i++) {
-        FreeItems.push_back(address);
-        address += ItemSize;
-    }
-
-    Lock = new MutexStandard();
+    AddItems(address, itemCount);
 }
 
 
@@ -130,34 +147,132 @@ MemoryPool::MemoryPool( int itemSize,
                         int preallocatedMemorySize,
                         int alignment)
     : ItemSize(itemSize),
-      Alignment(alignment)
+      Alignment(alignment),
+      FreeItems(NULL),
+      ItemFreed(NULL),
+      Waiters(0)
 {
+    StatsInit();
+
     CalculateValidAlignment();
 
     CalculateItemSize();
 
-    unsigned char *address = (unsigned char *)preallocatedMemory;
+    ItemFreed = xSemaphoreCreateCounting(MAX_WAITERS, 0);
 
-    while (preallocatedMemorySize >= ItemSize) {
+    if (ItemFreed == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MemoryPoolMallocException();
+#else
+        configASSERT(!"MemoryPool semaphore create Failed");
+#endif
+    }
+
+    AddItems((unsigned char *)preallocatedMemory,
+             preallocatedMemorySize / ItemSize);
+}
 
-        FreeItems.push_back(address);
+
+void MemoryPool::AddItems(unsigned char *address, int itemCount)
+{
+    if (itemCount <= 0)
+        return;
+
+    //
+    //  Build the chain outside of the lock, it's private to us
+    //  until it's spliced in.
+    //
+    FreeItem *head = (FreeItem *)address;
+    FreeItem *tail = head;
+
+    for (int i = 1; i < itemCount; i++) {
         address += ItemSize;
-        preallocatedMemorySize -= ItemSize;
+        tail->Next = (FreeItem *)address;
+        tail = tail->Next;
     }
 
-    Lock = new MutexStandard();
+    CriticalSection::Enter();
+
+    tail->Next = FreeItems;
+    FreeItems = head;
+    StatsAdded(itemCount);
+    int wake = ClaimWaiters(itemCount);
+
+    CriticalSection::Exit();
+
+    WakeWaiters(wake);
+}
+
+
+MemoryPool::FreeItem *MemoryPool::PopChain(int count, FreeItem **tail, int *popped)
+{
+    CriticalSection::Enter();
+
+    FreeItem *head = FreeItems;
+    FreeItem *last = NULL;
+    int n = 0;
+
+    for (FreeItem *item = FreeItems; item != NULL && n < count; item = item->Next) {
+        last = item;
+        n++;
+    }
+
+    if (last != NULL) {
+        FreeItems = last->Next;
+        last->Next = NULL;
+    }
+    else {
+        head = NULL;
+    }
+
+    StatsAllocated(n);
+
+    if (n == 0) {
+        StatsFailed(1);
+    }
+
+    CriticalSection::Exit();
+
+    *tail = last;
+    *popped = n;
+
+    return head;
+}
+
+
+void MemoryPool::PushChain(FreeItem *head, FreeItem *tail, int count)
+{
+    CriticalSection::Enter();
+
+    tail->Next = FreeItems;
+    FreeItems = head;
+    StatsFreed(count);
+    int wake = ClaimWaiters(count);
+
+    CriticalSection::Exit();
+
+    WakeWaiters(wake);
 }
 
 
 void *MemoryPool::Allocate()
 {
-    LockGuard guard(*Lock);
+    CriticalSection::Enter();
 
-    if (FreeItems.empty())
-        return NULL;
+    FreeItem *item = FreeItems;
 
-    void *item = FreeItems.front();
-    FreeItems.pop_front();
+    if (item != NULL) {
+        FreeItems = item->Next;
+    }
+
+    if (item != NULL) {
+        StatsAllocated(1);
+    }
+    else {
+        StatsFailed(1);
+    }
+
+    CriticalSection::Exit();
 
     return item;
 }
@@ -165,8 +280,166 @@ void *MemoryPool::Allocate()
 
 void MemoryPool::Free(void *item)
 {
-    LockGuard guard(*Lock);
-    FreeItems.push_back(item);
+    FreeItem *freeItem = (FreeItem *)item;
+
+    CriticalSection::Enter();
+
+    freeItem->Next = FreeItems;
+    FreeItems = freeItem;
+    StatsFreed(1);
+    int wake = ClaimWaiters(1);
+
+    CriticalSection::Exit();
+
+    WakeWaiters(wake);
+}
+
+
+void *MemoryPool::Allocate(TickType_t timeout)
+{
+    TimeOut_t timeOut;
+    vTaskSetTimeOutState(&timeOut);
+
+    while (true) {
+
+        CriticalSection::Enter();
+
+        FreeItem *item = FreeItems;
+
+        if (item != NULL) {
+            FreeItems = item->Next;
+            StatsAllocated(1);
+        }
+        else if (timeout != 0) {
+            Waiters++;
+        }
+        else {
+            StatsFailed(1);
+        }
+
+        CriticalSection::Exit();
+
+        if (item != NULL || timeout == 0) {
+            return item;
+        }
+
+        if (xSemaphoreTake(ItemFreed, timeout) == pdTRUE) {
+            //
+            //  Something was returned, but another task may still
+            //  beat us to it, so go around again with what's left.
+            //
+            if (xTaskCheckForTimeOut(&timeOut, &timeout) != pdFALSE) {
+                timeout = 0;
+            }
+            continue;
+        }
+
+        //
+        //  Timed out. Take ourselves off the waiter count, unless a
+        //  free already claimed us, in which case its give is on the
+        //  way and has to be consumed to keep the semaphore balanced.
+        //
+        CriticalSection::Enter();
+
+        bool claimed = (Waiters == 0);
+        if (!claimed) {
+            Waiters--;
+        }
+
+        CriticalSection::Exit();
+
+        if (claimed) {
+            xSemaphoreTake(ItemFreed, portMAX_DELAY);
+        }
+
+        //
+        //  One last non blocking try.
+        //
+        timeout = 0;
+    }
+}
+
+
+void *MemoryPool::AllocateFromISR()
+{
+    BaseType_t savedInterruptStatus = CriticalSection::EnterFromISR();
+
+    FreeItem *item = FreeItems;
+
+    if (item != NULL) {
+        FreeItems = item->Next;
+    }
+
+    if (item != NULL) {
+        StatsAllocated(1);
+    }
+    else {
+        StatsFailed(1);
+    }
+
+    CriticalSection::ExitFromISR(savedInterruptStatus);
+
+    return item;
+}
+
+
+void MemoryPool::FreeFromISR(void *item, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    FreeItem *freeItem = (FreeItem *)item;
+
+    BaseType_t savedInterruptStatus = CriticalSection::EnterFromISR();
+
+    freeItem->Next = FreeItems;
+    FreeItems = freeItem;
+    StatsFreed(1);
+    int wake = ClaimWaiters(1);
+
+    CriticalSection::ExitFromISR(savedInterruptStatus);
+
+    if (wake) {
+        xSemaphoreGiveFromISR(ItemFreed, pxHigherPriorityTaskWoken);
+    }
+}
+
+
+int MemoryPool::AllocateBatch(void **items, int count)
+{
+    int n = 0;
+
+    CriticalSection::Enter();
+
+    while (n < count && FreeItems != NULL) {
+        items[n++] = FreeItems;
+        FreeItems = FreeItems->Next;
+    }
+
+    StatsAllocated(n);
+    StatsFailed(count - n);
+
+    CriticalSection::Exit();
+
+    return n;
+}
+
+
+void MemoryPool::FreeBatch(void **items, int count)
+{
+    if (count <= 0)
+        return;
+
+    //
+    //  Link the items together outside of the lock, 
+    //  they're still ours until they're spliced in.
+    //
+    FreeItem *head = (FreeItem *)items[0];
+    FreeItem *tail = head;
+
+    for (int i = 1; i < count; i++) {
+        tail->Next = (FreeItem *)items[i];
+        tail = tail->Next;
+    }
+
+    PushChain(head, tail, count);
 }
 
 
@@ -182,29 +455,27 @@ void MemoryPool::AddMemory(int itemCount)
 #endif
     }
 
-    for (int i = 0; i < itemCount; i++) {
-
-        LockGuard guard(*Lock);
-
-        FreeItems.push_back(address);
-        address += ItemSize;
-    }
+    AddItems(address, itemCount);
 }
 
 
 void MemoryPool::AddMemory( void *preallocatedMemory,
                             int preallocatedMemorySize)
 {
-    unsigned char *address = (unsigned char *)preallocatedMemory;
-
-    while (preallocatedMemorySize >= ItemSize) {
-
-        LockGuard guard(*Lock);
-
-        FreeItems.push_back(address);
-        address += ItemSize;
-        preallocatedMemorySize -= ItemSize;
-    }
+    AddItems((unsigned char *)preallocatedMemory,
+             preallocatedMemorySize / ItemSize);
 }
 
 
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+void MemoryPool::GetStats(MemoryPoolStats &stats)
+{
+    stats.TotalItems = __atomic_load_n(&Stats.TotalItems, __ATOMIC_RELAXED);
+    stats.FreeItems = __atomic_load_n(&Stats.FreeItems, __ATOMIC_RELAXED);
+    stats.LowWaterMark = __atomic_load_n(&Stats.LowWaterMark, __ATOMIC_RELAXED);
+    stats.PeakUsage = __atomic_load_n(&Stats.PeakUsage, __ATOMIC_RELAXED);
+    stats.Allocations = __atomic_load_n(&Stats.Allocations, __ATOMIC_RELAXED);
+    stats.Frees = __atomic_load_n(&Stats.Frees, __ATOMIC_RELAXED);
+    stats.FailedAllocations = __atomic_load_n(&Stats.FailedAllocations, __ATOMIC_RELAXED);
+}
+#endif
@@ -0,0 +1,244 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+
+
+#include <stdlib.h>
+#include "mem_pool_cache.hpp"
+
+
+#if (configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0)
+
+
+using namespace cpp_freertos;
+
+
+MemoryPoolCache::MemoryPoolCache(   MemoryPool &pool,
+                                    BaseType_t tlsIndex,
+                                    int magazineSize)
+    : Pool(pool),
+      TlsIndex(tlsIndex),
+      MagazineSize(magazineSize)
+{
+    configASSERT(tlsIndex >= 0);
+    configASSERT(tlsIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS);
+
+    StatsInit();
+
+    if (MagazineSize < 1) {
+        MagazineSize = 1;
+    }
+}
+
+
+MemoryPoolCache::TaskCache *MemoryPoolCache::GetTaskCache()
+{
+    TaskCache *cache = (TaskCache *)
+        pvTaskGetThreadLocalStoragePointer(NULL, TlsIndex);
+
+    if (cache == NULL) {
+
+        cache = (TaskCache *)malloc(sizeof(TaskCache));
+
+        if (cache != NULL) {
+            cache->Loaded.Head = cache->Loaded.Tail = NULL;
+            cache->Loaded.Count = 0;
+            cache->Previous = cache->Loaded;
+            vTaskSetThreadLocalStoragePointer(NULL, TlsIndex, cache);
+        }
+    }
+
+    return cache;
+}
+
+
+void *MemoryPoolCache::Allocate()
+{
+    TaskCache *cache = GetTaskCache();
+
+    //
+    //  If we couldn't get a cache, just go straight to the pool.
+    //
+    if (cache == NULL) {
+        StatsAllocated(false);
+        StatsPoolLocked();
+        return Pool.Allocate();
+    }
+
+    Magazine &loaded = cache->Loaded;
+
+    if (loaded.Count == 0) {
+
+        if (cache->Previous.Count > 0) {
+            Swap(loaded, cache->Previous);
+            StatsAllocated(true);
+        }
+        else {
+            //
+            //  Both magazines are empty, get a full one from the pool.
+            //
+            StatsAllocated(false);
+            StatsPoolLocked();
+            loaded.Head = Pool.PopChain(MagazineSize, &loaded.Tail, &loaded.Count);
+
+            if (loaded.Count == 0) {
+                return NULL;
+            }
+        }
+    }
+    else {
+        StatsAllocated(true);
+    }
+
+    MemoryPool::FreeItem *item = loaded.Head;
+    loaded.Head = item->Next;
+
+    if (--loaded.Count == 0) {
+        loaded.Tail = NULL;
+    }
+
+    return item;
+}
+
+
+void MemoryPoolCache::Free(void *item)
+{
+    TaskCache *cache = GetTaskCache();
+
+    if (cache == NULL) {
+        StatsFreed(false);
+        StatsPoolLocked();
+        Pool.Free(item);
+        return;
+    }
+
+    Magazine &loaded = cache->Loaded;
+
+    if (loaded.Count >= MagazineSize) {
+
+        if (cache->Previous.Count == 0) {
+            Swap(loaded, cache->Previous);
+            StatsFreed(true);
+        }
+        else {
+            //
+            //  Both magazines are full, give one back to the pool
+            //  and keep going with an empty one.
+            //
+            StatsFreed(false);
+            StatsPoolLocked();
+            Pool.PushChain(cache->Previous.Head, cache->Previous.Tail,
+                           cache->Previous.Count);
+            cache->Previous = loaded;
+            loaded.Head = loaded.Tail = NULL;
+            loaded.Count = 0;
+        }
+    }
+    else {
+        StatsFreed(true);
+    }
+
+    MemoryPool::FreeItem *freeItem = (MemoryPool::FreeItem *)item;
+
+    freeItem->Next = loaded.Head;
+    loaded.Head = freeItem;
+
+    if (loaded.Count++ == 0) {
+        loaded.Tail = freeItem;
+    }
+}
+
+
+void MemoryPoolCache::ReleaseTaskCache()
+{
+    TaskCache *cache = (TaskCache *)
+        pvTaskGetThreadLocalStoragePointer(NULL, TlsIndex);
+
+    if (cache == NULL) {
+        return;
+    }
+
+    vTaskSetThreadLocalStoragePointer(NULL, TlsIndex, NULL);
+
+    Magazine &loaded = cache->Loaded;
+    Magazine &previous = cache->Previous;
+
+    //
+    //  Join the two magazines so they go back in one critical section.
+    //
+    if (loaded.Count == 0) {
+        loaded = previous;
+    }
+    else if (previous.Count > 0) {
+        loaded.Tail->Next = previous.Head;
+        loaded.Tail = previous.Tail;
+        loaded.Count += previous.Count;
+    }
+
+    if (loaded.Head != NULL) {
+        StatsPoolLocked();
+        Pool.PushChain(loaded.Head, loaded.Tail, loaded.Count);
+    }
+
+    free(cache);
+}
+
+
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+void MemoryPoolCache::GetStats(MemoryPoolCacheStats &stats)
+{
+    stats.Allocations = __atomic_load_n(&Allocations, __ATOMIC_RELAXED);
+    stats.AllocationHits = __atomic_load_n(&AllocationHits, __ATOMIC_RELAXED);
+    stats.Frees = __atomic_load_n(&Frees, __ATOMIC_RELAXED);
+    stats.FreeHits = __atomic_load_n(&FreeHits, __ATOMIC_RELAXED);
+    stats.PoolLocks = __atomic_load_n(&PoolLocks, __ATOMIC_RELAXED);
+
+    unsigned long uncached = stats.Allocations + stats.Frees;
+
+    stats.PoolLocksSaved = uncached > stats.PoolLocks ? 
+                                uncached - stats.PoolLocks : 0;
+}
+#endif
+
+
+#endif
+
@@ -0,0 +1,368 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "message_ring.hpp"
+#include "task.h"
+
+
+using namespace cpp_freertos;
+
+
+MessageRing::MessageRing(int size)
+    : Buffer(NULL),
+      Size(size),
+      Allocated(true)
+{
+    Buffer = (unsigned char *)malloc(size);
+
+    if (Buffer == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MessageRingCreateException();
+#else
+        configASSERT(!"MessageRing malloc Failed");
+#endif
+    }
+
+    Initialize();
+}
+
+
+MessageRing::MessageRing(void *buffer, int size)
+    : Buffer((unsigned char *)buffer),
+      Size(size),
+      Allocated(false)
+{
+    Initialize();
+}
+
+
+void MessageRing::Initialize()
+{
+    Size &= ~(Slot - 1);
+    Head = 0;
+    Tail = 0;
+    Reserved = 0;
+    ReservedSize = 0;
+    PeekedSize = 0;
+    ProducerWaiting = 0;
+    ConsumerWaiting = 0;
+
+    if (Size < 4 * Slot || ((uintptr_t)Buffer & (Slot - 1)) != 0) {
+        if (Allocated) {
+            free(Buffer);
+        }
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MessageRingCreateException();
+#else
+        configASSERT(!"MessageRing Bad Buffer");
+#endif
+    }
+
+    SpaceAvailable = xSemaphoreCreateBinary();
+    DataAvailable = xSemaphoreCreateBinary();
+
+    if (SpaceAvailable == NULL || DataAvailable == NULL) {
+        if (SpaceAvailable != NULL) {
+            vSemaphoreDelete(SpaceAvailable);
+        }
+        if (DataAvailable != NULL) {
+            vSemaphoreDelete(DataAvailable);
+        }
+        if (Allocated) {
+            free(Buffer);
+        }
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MessageRingCreateException();
+#else
+        configASSERT(!"MessageRing semaphore create Failed");
+#endif
+    }
+}
+
+
+MessageRing::~MessageRing()
+{
+    vSemaphoreDelete(DataAvailable);
+    vSemaphoreDelete(SpaceAvailable);
+
+    if (Allocated) {
+        free(Buffer);
+    }
+}
+
+
+bool MessageRing::MessageFits(int size)
+{
+    //
+    //  Anything up to half the ring fits on one side or the other
+    //  of wherever the ring drains to.
+    //
+    return size >= 0 && Slot + RoundUp(size) <= (Size - Slot) / 2;
+}
+
+
+void *MessageRing::TryReserve(int size)
+{
+    int needed = Slot + RoundUp(size);
+    int head = Head;
+    int tail = __atomic_load_n(&Tail, __ATOMIC_ACQUIRE);
+    int offset;
+
+    //
+    //  Head can never be allowed to catch up with Tail, 
+    //  or a full ring would look empty.
+    //
+    if (head >= tail) {
+
+        if (needed < Size - head || (needed == Size - head && tail != 0)) {
+            offset = head;
+        }
+        else if (needed < tail) {
+            //
+            //  Not enough room at the end, start over at the beginning.
+            //  The consumer can't see this until we commit.
+            //
+            *(int *)(Buffer + head) = Wrap;
+            offset = 0;
+        }
+        else {
+            return NULL;
+        }
+    }
+    else if (needed < tail - head) {
+        offset = head;
+    }
+    else {
+        return NULL;
+    }
+
+    Reserved = offset;
+    ReservedSize = needed;
+
+    return Buffer + offset + Slot;
+}
+
+
+void *MessageRing::Reserve(int size, TickType_t Timeout)
+{
+    if (!MessageFits(size)) {
+        return NULL;
+    }
+
+    TimeOut_t timeOut;
+    vTaskSetTimeOutState(&timeOut);
+
+    while (true) {
+
+        void *message = TryReserve(size);
+
+        if (message != NULL || Timeout == 0) {
+            return message;
+        }
+
+        //
+        //  Announce that we're waiting, then look again in case the
+        //  consumer released something before it could see that.
+        //
+        __atomic_store_n(&ProducerWaiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        message = TryReserve(size);
+
+        if (message == NULL) {
+            xSemaphoreTake(SpaceAvailable, Timeout);
+        }
+
+        __atomic_store_n(&ProducerWaiting, 0, __ATOMIC_RELAXED);
+
+        if (message != NULL) {
+            return message;
+        }
+
+        if (xTaskCheckForTimeOut(&timeOut, &Timeout) != pdFALSE) {
+            Timeout = 0;
+        }
+    }
+}
+
+
+void *MessageRing::ReserveFromISR(int size)
+{
+    if (!MessageFits(size)) {
+        return NULL;
+    }
+
+    return TryReserve(size);
+}
+
+
+bool MessageRing::CommitInternal(int size)
+{
+    int needed = Slot + RoundUp(size);
+    configASSERT(size >= 0 && needed <= ReservedSize);
+
+    *(int *)(Buffer + Reserved) = size;
+
+    int head = Reserved + needed;
+    if (head == Size) {
+        head = 0;
+    }
+
+    __atomic_store_n(&Head, head, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&ConsumerWaiting, __ATOMIC_RELAXED) != 0;
+}
+
+
+void MessageRing::Commit(int size)
+{
+    if (CommitInternal(size)) {
+        xSemaphoreGive(DataAvailable);
+    }
+}
+
+
+void MessageRing::CommitFromISR(int size, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (CommitInternal(size)) {
+        xSemaphoreGiveFromISR(DataAvailable, pxHigherPriorityTaskWoken);
+    }
+}
+
+
+void *MessageRing::TryPeek(int &size)
+{
+    int head = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+    int tail = Tail;
+
+    while (tail != head) {
+
+        int length = *(int *)(Buffer + tail);
+
+        if (length == Wrap) {
+            tail = 0;
+            __atomic_store_n(&Tail, tail, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        PeekedSize = Slot + RoundUp(length);
+        size = length;
+
+        return Buffer + tail + Slot;
+    }
+
+    return NULL;
+}
+
+
+void *MessageRing::Peek(int &size, TickType_t Timeout)
+{
+    TimeOut_t timeOut;
+    vTaskSetTimeOutState(&timeOut);
+
+    while (true) {
+
+        void *message = TryPeek(size);
+
+        if (message != NULL || Timeout == 0) {
+            return message;
+        }
+
+        __atomic_store_n(&ConsumerWaiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        message = TryPeek(size);
+
+        if (message == NULL) {
+            xSemaphoreTake(DataAvailable, Timeout);
+        }
+
+        __atomic_store_n(&ConsumerWaiting, 0, __ATOMIC_RELAXED);
+
+        if (message != NULL) {
+            return message;
+        }
+
+        if (xTaskCheckForTimeOut(&timeOut, &Timeout) != pdFALSE) {
+            Timeout = 0;
+        }
+    }
+}
+
+
+void *MessageRing::PeekFromISR(int &size)
+{
+    return TryPeek(size);
+}
+
+
+bool MessageRing::ReleaseInternal()
+{
+    int tail = Tail + PeekedSize;
+    if (tail == Size) {
+        tail = 0;
+    }
+
+    __atomic_store_n(&Tail, tail, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&ProducerWaiting, __ATOMIC_RELAXED) != 0;
+}
+
+
+void MessageRing::Release()
+{
+    if (ReleaseInternal()) {
+        xSemaphoreGive(SpaceAvailable);
+    }
+}
+
+
+void MessageRing::ReleaseFromISR(BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (ReleaseInternal()) {
+        xSemaphoreGiveFromISR(SpaceAvailable, pxHigherPriorityTaskWoken);
+    }
+}
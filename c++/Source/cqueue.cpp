@@ -40,15 +40,40 @@
 
 
 
+#include <stddef.h>
+#include <string.h>
 #include "queue.hpp"
+#include "task.h"
 
 
 using namespace cpp_freertos;
 
 
+#ifdef CPP_FREERTOS_QUEUE_STATS
+/**
+ *  What a timestamped queue really holds, the tick count the item 
+ *  was enqueued at, followed by the item.
+ */
+struct StampedItem {
+    TickType_t Stamp;
+    uint8_t Item[CPP_FREERTOS_QUEUE_STATS_MAX_ITEM_SIZE];
+};
+
+#define STAMP_SIZE  (offsetof(StampedItem, Item))
+#endif
+
+
 Queue::Queue(UBaseType_t maxItems, UBaseType_t itemSize)
+    : itemSize(itemSize)
 {
+#ifdef CPP_FREERTOS_QUEUE_STATS
+    timestamped = (itemSize <= CPP_FREERTOS_QUEUE_STATS_MAX_ITEM_SIZE);
+    memset(&statistics, 0, sizeof(statistics));
+
+    handle = xQueueCreate(maxItems, timestamped ? STAMP_SIZE + itemSize : itemSize);
+#else
     handle = xQueueCreate(maxItems, itemSize);
+#endif
 
     if (handle == NULL) {
 #ifndef CPP_FREERTOS_NO_EXCEPTIONS
@@ -66,11 +91,238 @@ Queue::~Queue()
 }
 
 
+#ifdef CPP_FREERTOS_QUEUE_STATS
+
+BaseType_t Queue::Send(const void *item, TickType_t Timeout, BaseType_t position)
+{
+    BaseType_t success;
+    TickType_t start = xTaskGetTickCount();
+
+    if (timestamped) {
+
+        StampedItem staging;
+
+        staging.Stamp = start;
+        memcpy(staging.Item, item, itemSize);
+
+        success = xQueueGenericSend(handle, &staging, Timeout, position);
+    }
+    else {
+        success = xQueueGenericSend(handle, item, Timeout, position);
+    }
+
+    StatsSent(success, Timeout, xTaskGetTickCount() - start, uxQueueMessagesWaiting(handle));
+
+    return success;
+}
+
+
+BaseType_t Queue::SendFromISR(   const void *item, 
+                                 BaseType_t *pxHigherPriorityTaskWoken, 
+                                 BaseType_t position)
+{
+    BaseType_t success;
+
+    if (timestamped) {
+
+        StampedItem staging;
+
+        staging.Stamp = xTaskGetTickCountFromISR();
+        memcpy(staging.Item, item, itemSize);
+
+        success = xQueueGenericSendFromISR(handle, &staging, pxHigherPriorityTaskWoken, position);
+    }
+    else {
+        success = xQueueGenericSendFromISR(handle, item, pxHigherPriorityTaskWoken, position);
+    }
+
+    StatsSent(success, 0, 0, uxQueueMessagesWaitingFromISR(handle));
+
+    return success;
+}
+
+
+BaseType_t Queue::Receive(void *item, TickType_t Timeout)
+{
+    BaseType_t success;
+    TickType_t start = xTaskGetTickCount();
+
+    if (timestamped) {
+
+        StampedItem staging;
+
+        success = xQueueReceive(handle, &staging, Timeout);
+
+        TickType_t now = xTaskGetTickCount();
+
+        StatsReceived(success, Timeout, now - start);
+
+        if (success == pdTRUE) {
+            memcpy(item, staging.Item, itemSize);
+            StatsResidency(now - staging.Stamp);
+        }
+    }
+    else {
+        success = xQueueReceive(handle, item, Timeout);
+
+        StatsReceived(success, Timeout, xTaskGetTickCount() - start);
+    }
+
+    return success;
+}
+
+
+BaseType_t Queue::ReceiveFromISR(void *item, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    BaseType_t success;
+
+    if (timestamped) {
+
+        StampedItem staging;
+
+        success = xQueueReceiveFromISR(handle, &staging, pxHigherPriorityTaskWoken);
+
+        StatsReceived(success, 0, 0);
+
+        if (success == pdTRUE) {
+            memcpy(item, staging.Item, itemSize);
+            StatsResidency(xTaskGetTickCountFromISR() - staging.Stamp);
+        }
+    }
+    else {
+        success = xQueueReceiveFromISR(handle, item, pxHigherPriorityTaskWoken);
+
+        StatsReceived(success, 0, 0);
+    }
+
+    return success;
+}
+
+
+void Queue::StatsSent(   BaseType_t success, 
+                         TickType_t Timeout, 
+                         TickType_t blocked, 
+                         UBaseType_t depth)
+{
+    if (success == pdTRUE) {
+
+        __atomic_fetch_add(&statistics.Enqueues, 1, __ATOMIC_RELAXED);
+
+        UBaseType_t peak = __atomic_load_n(&statistics.PeakDepth, __ATOMIC_RELAXED);
+
+        while (depth > peak) {
+            if (__atomic_compare_exchange_n(&statistics.PeakDepth, &peak, depth, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        }
+    }
+    else if (Timeout != 0) {
+        __atomic_fetch_add(&statistics.EnqueueTimeouts, 1, __ATOMIC_RELAXED);
+    }
+
+    if (blocked != 0) {
+        __atomic_fetch_add(&statistics.ProducerBlockedTicks, blocked, __ATOMIC_RELAXED);
+    }
+}
+
+
+void Queue::StatsReceived(   BaseType_t success, 
+                             TickType_t Timeout, 
+                             TickType_t blocked)
+{
+    if (success == pdTRUE) {
+        __atomic_fetch_add(&statistics.Dequeues, 1, __ATOMIC_RELAXED);
+    }
+    else if (Timeout != 0) {
+        __atomic_fetch_add(&statistics.DequeueTimeouts, 1, __ATOMIC_RELAXED);
+    }
+
+    if (blocked != 0) {
+        __atomic_fetch_add(&statistics.ConsumerBlockedTicks, blocked, __ATOMIC_RELAXED);
+    }
+}
+
+
+void Queue::StatsResidency(TickType_t ticks)
+{
+    int bucket = 0;
+
+    while (ticks != 0 && bucket < CPP_FREERTOS_QUEUE_STATS_BUCKETS - 1) {
+        ticks >>= 1;
+        bucket++;
+    }
+
+    __atomic_fetch_add(&statistics.Residency[bucket], 1, __ATOMIC_RELAXED);
+}
+
+
+void Queue::GetStats(QueueStats &stats)
+{
+    stats.PeakDepth = __atomic_load_n(&statistics.PeakDepth, __ATOMIC_RELAXED);
+    stats.Enqueues = __atomic_load_n(&statistics.Enqueues, __ATOMIC_RELAXED);
+    stats.Dequeues = __atomic_load_n(&statistics.Dequeues, __ATOMIC_RELAXED);
+    stats.EnqueueTimeouts = __atomic_load_n(&statistics.EnqueueTimeouts, __ATOMIC_RELAXED);
+    stats.DequeueTimeouts = __atomic_load_n(&statistics.DequeueTimeouts, __ATOMIC_RELAXED);
+    stats.ProducerBlockedTicks = __atomic_load_n(&statistics.ProducerBlockedTicks, __ATOMIC_RELAXED);
+    stats.ConsumerBlockedTicks = __atomic_load_n(&statistics.ConsumerBlockedTicks, __ATOMIC_RELAXED);
+
+    for (int i = 0; i < CPP_FREERTOS_QUEUE_STATS_BUCKETS; i++) {
+        stats.Residency[i] = __atomic_load_n(&statistics.Residency[i], __ATOMIC_RELAXED);
+    }
+}
+
+
+void Queue::ResetStats()
+{
+    __atomic_store_n(&statistics.PeakDepth, uxQueueMessagesWaiting(handle), __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics.Enqueues, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics.Dequeues, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics.EnqueueTimeouts, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics.DequeueTimeouts, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics.ProducerBlockedTicks, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics.ConsumerBlockedTicks, 0, __ATOMIC_RELAXED);
+
+    for (int i = 0; i < CPP_FREERTOS_QUEUE_STATS_BUCKETS; i++) {
+        __atomic_store_n(&statistics.Residency[i], 0, __ATOMIC_RELAXED);
+    }
+}
+
+#else
+
+BaseType_t Queue::Send(const void *item, TickType_t Timeout, BaseType_t position)
+{
+    return xQueueGenericSend(handle, item, Timeout, position);
+}
+
+
+BaseType_t Queue::SendFromISR(   const void *item, 
+                                 BaseType_t *pxHigherPriorityTaskWoken, 
+                                 BaseType_t position)
+{
+    return xQueueGenericSendFromISR(handle, item, pxHigherPriorityTaskWoken, position);
+}
+
+
+BaseType_t Queue::Receive(void *item, TickType_t Timeout)
+{
+    return xQueueReceive(handle, item, Timeout);
+}
+
+
+BaseType_t Queue::ReceiveFromISR(void *item, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    return xQueueReceiveFromISR(handle, item, pxHigherPriorityTaskWoken);
+}
+
+#endif
+
+
 bool Queue::Enqueue(const void *item)
 {
     BaseType_t success;
 
-    success = xQueueSendToBack(handle, item, portMAX_DELAY);
+    success = Send(item, portMAX_DELAY, queueSEND_TO_BACK);
 
     return success == pdTRUE ? true : false;
 }
@@ -80,7 +332,7 @@ bool Queue::Enqueue(const void *item, TickType_t Timeout)
 {
     BaseType_t success;
 
-    success = xQueueSendToBack(handle, item, Timeout);
+    success = Send(item, Timeout, queueSEND_TO_BACK);
 
     return success == pdTRUE ? true : false;
 }
@@ -90,7 +342,7 @@ bool Queue::Dequeue(void *item, TickType_t Timeout)
 {
     BaseType_t success;
 
-    success = xQueueReceive(handle, item, Timeout);
+    success = Receive(item, Timeout);
 
     return success == pdTRUE ? true : false;
 }
@@ -100,17 +352,88 @@ bool Queue::Peek(void *item, TickType_t Timeout)
 {
     BaseType_t success;
 
+#ifdef CPP_FREERTOS_QUEUE_STATS
+    if (timestamped) {
+
+        StampedItem staging;
+
+        success = xQueuePeek(handle, &staging, Timeout);
+
+        if (success == pdTRUE) {
+            memcpy(item, staging.Item, itemSize);
+        }
+
+        return success == pdTRUE ? true : false;
+    }
+#endif
+
     success = xQueuePeek(handle, item, Timeout);
 
     return success == pdTRUE ? true : false;
 }
 
 
+UBaseType_t Queue::EnqueueMany( const void *items, 
+                                UBaseType_t count, 
+                                TickType_t Timeout)
+{
+    const uint8_t *item = (const uint8_t *)items;
+    TimeOut_t timeOut;
+    UBaseType_t i;
+
+    vTaskSetTimeOutState(&timeOut);
+
+    for (i = 0; i < count; i++, item += itemSize) {
+
+        if (Send(item, Timeout, queueSEND_TO_BACK) != pdTRUE) {
+            break;
+        }
+
+        //
+        //  The timeout covers the whole batch, not each item.
+        //
+        if (xTaskCheckForTimeOut(&timeOut, &Timeout) != pdFALSE) {
+            Timeout = 0;
+        }
+    }
+
+    return i;
+}
+
+
+UBaseType_t Queue::DequeueMany( void *items, 
+                                UBaseType_t maxItems, 
+                                TickType_t Timeout)
+{
+    uint8_t *item = (uint8_t *)items;
+    UBaseType_t i;
+
+    if (maxItems == 0) {
+        return 0;
+    }
+
+    if (Receive(item, Timeout) != pdTRUE) {
+        return 0;
+    }
+
+    for (i = 1; i < maxItems; i++) {
+
+        item += itemSize;
+
+        if (Receive(item, 0) != pdTRUE) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
 bool Queue::EnqueueFromISR(const void *item, BaseType_t *pxHigherPriorityTaskWoken)
 {
     BaseType_t success;
 
-    success = xQueueSendToBackFromISR(handle, item, pxHigherPriorityTaskWoken);
+    success = SendFromISR(item, pxHigherPriorityTaskWoken, queueSEND_TO_BACK);
 
     return success == pdTRUE ? true : false;
 }
@@ -120,7 +443,7 @@ bool Queue::DequeueFromISR(void *item, BaseType_t *pxHigherPriorityTaskWoken)
 {
     BaseType_t success;
 
-    success = xQueueReceiveFromISR(handle, item, pxHigherPriorityTaskWoken);
+    success = ReceiveFromISR(item, pxHigherPriorityTaskWoken);
 
     return success == pdTRUE ? true : false;
 }
@@ -130,6 +453,21 @@ bool Queue::PeekFromISR(void *item)
 {
     BaseType_t success;
 
+#ifdef CPP_FREERTOS_QUEUE_STATS
+    if (timestamped) {
+
+        StampedItem staging;
+
+        success = xQueuePeekFromISR(handle, &staging);
+
+        if (success == pdTRUE) {
+            memcpy(item, staging.Item, itemSize);
+        }
+
+        return success == pdTRUE ? true : false;
+    }
+#endif
+
     success = xQueuePeekFromISR(handle, item);
 
     return success == pdTRUE ? true : false;
@@ -180,7 +518,7 @@ bool Deque::EnqueueToFront(void *item, TickType_t Timeout)
 {
     BaseType_t success;
 
-    success = xQueueSendToFront(handle, item, Timeout);
+    success = Send(item, Timeout, queueSEND_TO_FRONT);
 
     return success == pdTRUE ? true : false;
 }
@@ -190,7 +528,7 @@ bool Deque::EnqueueToFrontFromISR(void *item, BaseType_t *pxHigherPriorityTaskWo
 {
     BaseType_t success;
 
-    success = xQueueSendToFrontFromISR(handle, item, pxHigherPriorityTaskWoken);
+    success = SendFromISR(item, pxHigherPriorityTaskWoken, queueSEND_TO_FRONT);
 
     return success == pdTRUE ? true : false;
 }
@@ -204,13 +542,13 @@ BinaryQueue::BinaryQueue(UBaseType_t itemSize)
 
 bool BinaryQueue::Enqueue(void *item)
 {
-    (void)xQueueOverwrite(handle, item);
+    (void)Send(item, 0, queueOVERWRITE);
     return true;
 }
 
 
 bool BinaryQueue::EnqueueFromISR(void *item, BaseType_t *pxHigherPriorityTaskWoken)
 {
-    (void)xQueueOverwriteFromISR(handle, item, pxHigherPriorityTaskWoken);
+    (void)SendFromISR(item, pxHigherPriorityTaskWoken, queueOVERWRITE);
     return true;
 }
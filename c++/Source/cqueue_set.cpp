@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include "queue_set.hpp"
+
+
+#if( configUSE_QUEUE_SETS == 1 )
+
+using namespace cpp_freertos;
+
+
+QueueSet::QueueSet(UBaseType_t maxEvents)
+{
+    handle = xQueueCreateSet(maxEvents);
+
+    if (handle == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw QueueSetCreateException();
+#else
+        configASSERT(!"QueueSet Constructor Failed");
+#endif
+    }
+}
+
+
+QueueSet::~QueueSet()
+{
+    vQueueDelete(handle);
+}
+
+
+bool QueueSet::Add(Queue &queue)
+{
+    BaseType_t success;
+
+    success = xQueueAddToSet(HandleOf(queue), handle);
+
+    return success == pdPASS ? true : false;
+}
+
+
+bool QueueSet::Add(Semaphore &semaphore)
+{
+    BaseType_t success;
+
+    success = xQueueAddToSet(HandleOf(semaphore), handle);
+
+    return success == pdPASS ? true : false;
+}
+
+
+bool QueueSet::Remove(Queue &queue)
+{
+    BaseType_t success;
+
+    success = xQueueRemoveFromSet(HandleOf(queue), handle);
+
+    return success == pdPASS ? true : false;
+}
+
+
+bool QueueSet::Remove(Semaphore &semaphore)
+{
+    BaseType_t success;
+
+    success = xQueueRemoveFromSet(HandleOf(semaphore), handle);
+
+    return success == pdPASS ? true : false;
+}
+
+
+QueueSet::Member QueueSet::Select(TickType_t Timeout)
+{
+    return Member(xQueueSelectFromSet(handle, Timeout));
+}
+
+
+QueueSet::Member QueueSet::SelectFromISR()
+{
+    return Member(xQueueSelectFromSetFromISR(handle));
+}
+
+#endif /* configUSE_QUEUE_SETS */
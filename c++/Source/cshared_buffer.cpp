@@ -0,0 +1,256 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include "shared_buffer.hpp"
+
+
+using namespace cpp_freertos;
+
+
+/**
+ *  Round the header up so the data that follows it is aligned for
+ *  any fundamental type.
+ */
+#define DATA_ALIGNMENT  (2 * sizeof(void *))
+
+const int SharedBuffer::HeaderSize = 
+    (sizeof(SharedBuffer::Header) + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+
+
+SharedBuffer::SharedBuffer()
+    : Buffer(NULL)
+{
+}
+
+
+SharedBuffer::SharedBuffer(Header *buffer)
+    : Buffer(buffer)
+{
+}
+
+
+SharedBuffer SharedBuffer::Init(MemoryPool &pool, void *item)
+{
+    Header *buffer = (Header *)item;
+
+    if (buffer != NULL) {
+        buffer->Pool = &pool;
+        buffer->RefCount = 1;
+    }
+
+    return SharedBuffer(buffer);
+}
+
+
+SharedBuffer SharedBuffer::Allocate(MemoryPool &pool)
+{
+    configASSERT(pool.GetItemSize() > HeaderSize);
+
+    return Init(pool, pool.Allocate());
+}
+
+
+SharedBuffer SharedBuffer::Allocate(MemoryPool &pool, TickType_t timeout)
+{
+    configASSERT(pool.GetItemSize() > HeaderSize);
+
+    return Init(pool, pool.Allocate(timeout));
+}
+
+
+SharedBuffer SharedBuffer::AllocateFromISR(MemoryPool &pool)
+{
+    return Init(pool, pool.AllocateFromISR());
+}
+
+
+SharedBuffer SharedBuffer::Adopt(void *token)
+{
+    return SharedBuffer((Header *)token);
+}
+
+
+SharedBuffer::SharedBuffer(const SharedBuffer &other)
+    : Buffer(other.Buffer)
+{
+    AddRef();
+}
+
+
+SharedBuffer &SharedBuffer::operator=(const SharedBuffer &other)
+{
+    //
+    //  Add first, in case we are being assigned to ourselves.
+    //
+    Header *buffer = other.Buffer;
+
+    if (buffer != NULL) {
+        __atomic_add_fetch(&buffer->RefCount, 1, __ATOMIC_RELAXED);
+    }
+
+    Release();
+    Buffer = buffer;
+
+    return *this;
+}
+
+
+#if __cplusplus >= 201103L
+SharedBuffer::SharedBuffer(SharedBuffer &&other) noexcept
+    : Buffer(other.Buffer)
+{
+    other.Buffer = NULL;
+}
+
+
+SharedBuffer &SharedBuffer::operator=(SharedBuffer &&other) noexcept
+{
+    if (this != &other) {
+        Release();
+        Buffer = other.Buffer;
+        other.Buffer = NULL;
+    }
+
+    return *this;
+}
+#endif
+
+
+SharedBuffer::~SharedBuffer()
+{
+    Release();
+}
+
+
+void SharedBuffer::AddRef()
+{
+    if (Buffer != NULL) {
+        __atomic_add_fetch(&Buffer->RefCount, 1, __ATOMIC_RELAXED);
+    }
+}
+
+
+bool SharedBuffer::DropRef()
+{
+    //
+    //  Acquire/release so that every write to the data made under 
+    //  any reference is visible before the item is reused.
+    //
+    return __atomic_sub_fetch(&Buffer->RefCount, 1, __ATOMIC_ACQ_REL) == 0;
+}
+
+
+void *SharedBuffer::Share()
+{
+    configASSERT(Buffer != NULL);
+
+    AddRef();
+
+    return Buffer;
+}
+
+
+void *SharedBuffer::Detach()
+{
+    Header *buffer = Buffer;
+    Buffer = NULL;
+
+    return buffer;
+}
+
+
+void SharedBuffer::Release()
+{
+    if (Buffer == NULL) {
+        return;
+    }
+
+    if (DropRef()) {
+        Buffer->Pool->Free(Buffer);
+    }
+
+    Buffer = NULL;
+}
+
+
+void SharedBuffer::ReleaseFromISR(BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (Buffer == NULL) {
+        return;
+    }
+
+    if (DropRef()) {
+        Buffer->Pool->FreeFromISR(Buffer, pxHigherPriorityTaskWoken);
+    }
+
+    Buffer = NULL;
+}
+
+
+void *SharedBuffer::GetData() const
+{
+    if (Buffer == NULL) {
+        return NULL;
+    }
+
+    return (unsigned char *)Buffer + HeaderSize;
+}
+
+
+int SharedBuffer::GetSize() const
+{
+    if (Buffer == NULL) {
+        return 0;
+    }
+
+    return Buffer->Pool->GetItemSize() - HeaderSize;
+}
+
+
+int SharedBuffer::GetRefCount() const
+{
+    if (Buffer == NULL) {
+        return 0;
+    }
+
+    return __atomic_load_n(&Buffer->RefCount, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,253 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "size_class_allocator.hpp"
+#ifdef CPP_FREERTOS_SIZE_CLASS_OPERATOR_NEW
+#include <new>
+#endif
+
+
+using namespace cpp_freertos;
+
+
+SizeClassAllocator *SizeClassAllocator::GlobalAllocator = NULL;
+
+
+SizeClassAllocator::SizeClassAllocator(const int itemCounts[NumSizeClasses])
+{
+    //
+    //  MinClassSize is 2^4, SizeToClass() depends on it.
+    //
+    configASSERT(MinClassSize == 16);
+
+    size_t totalSize = 0;
+
+    for (int i = 0; i < NumSizeClasses; i++) {
+        totalSize += (size_t)(MinClassSize << i) * itemCounts[i];
+    }
+
+    //
+    //  Over allocate so we can align the first item.
+    //
+    unsigned char *address = (unsigned char *)
+                                malloc(totalSize + SizeClassAlignment);
+
+    if (address == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw MemoryPoolMallocException();
+#else
+        configASSERT(!"SizeClassAllocator malloc Failed");
+#endif
+    }
+
+    address = (unsigned char *)(((uintptr_t)address + SizeClassAlignment - 1)
+                                & ~((uintptr_t)SizeClassAlignment - 1));
+
+    for (int i = 0; i < NumSizeClasses; i++) {
+
+        int classSize = MinClassSize << i;
+
+        ClassStart[i] = address;
+
+        Pools[i] = new MemoryPool(  classSize,
+                                    address,
+                                    classSize * itemCounts[i],
+                                    SizeClassAlignment);
+
+        address += classSize * itemCounts[i];
+    }
+
+    ClassStart[NumSizeClasses] = address;
+}
+
+
+void *SizeClassAllocator::Allocate(size_t size)
+{
+    for (int i = SizeToClass(size); i < NumSizeClasses; i++) {
+
+        void *item = Pools[i]->Allocate();
+
+        if (item != NULL) {
+            return item;
+        }
+    }
+
+    return malloc(size);
+}
+
+
+void SizeClassAllocator::Free(void *item)
+{
+    unsigned char *address = (unsigned char *)item;
+
+    if (address < ClassStart[0] || address >= ClassStart[NumSizeClasses]) {
+        free(item);
+        return;
+    }
+
+    for (int i = NumSizeClasses - 1; i >= 0; i--) {
+        if (address >= ClassStart[i]) {
+            Pools[i]->Free(item);
+            return;
+        }
+    }
+}
+
+
+void SizeClassAllocator::Install(SizeClassAllocator *allocator)
+{
+    GlobalAllocator = allocator;
+}
+
+
+#ifdef CPP_FREERTOS_SIZE_CLASS_OPERATOR_NEW
+
+
+static inline void *SizeClassNew(size_t size)
+{
+    SizeClassAllocator *allocator = SizeClassAllocator::Installed();
+
+    if (size == 0) {
+        size = 1;
+    }
+
+    return allocator ? allocator->Allocate(size) : malloc(size);
+}
+
+
+static inline void SizeClassDelete(void *item)
+{
+    SizeClassAllocator *allocator = SizeClassAllocator::Installed();
+
+    if (allocator) {
+        allocator->Free(item);
+    }
+    else {
+        free(item);
+    }
+}
+
+
+static inline void *SizeClassNewOrFail(size_t size)
+{
+    void *item = SizeClassNew(size);
+
+    if (item == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw std::bad_alloc();
+#else
+        configASSERT(!"operator new Failed");
+#endif
+    }
+
+    return item;
+}
+
+
+void *operator new(size_t size)
+{
+    return SizeClassNewOrFail(size);
+}
+
+
+void *operator new[](size_t size)
+{
+    return SizeClassNewOrFail(size);
+}
+
+
+void *operator new(size_t size, const std::nothrow_t &) throw()
+{
+    return SizeClassNew(size);
+}
+
+
+void *operator new[](size_t size, const std::nothrow_t &) throw()
+{
+    return SizeClassNew(size);
+}
+
+
+void operator delete(void *item) throw()
+{
+    SizeClassDelete(item);
+}
+
+
+void operator delete[](void *item) throw()
+{
+    SizeClassDelete(item);
+}
+
+
+void operator delete(void *item, const std::nothrow_t &) throw()
+{
+    SizeClassDelete(item);
+}
+
+
+void operator delete[](void *item, const std::nothrow_t &) throw()
+{
+    SizeClassDelete(item);
+}
+
+
+#if __cpp_sized_deallocation
+void operator delete(void *item, size_t) throw()
+{
+    SizeClassDelete(item);
+}
+
+
+void operator delete[](void *item, size_t) throw()
+{
+    SizeClassDelete(item);
+}
+#endif
+
+
+#endif
+
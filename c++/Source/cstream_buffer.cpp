@@ -0,0 +1,254 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include "stream_buffer.hpp"
+
+
+using namespace cpp_freertos;
+
+
+StreamBuffer::StreamBuffer(size_t bufferSize, size_t triggerLevel)
+{
+    handle = xStreamBufferCreate(bufferSize, triggerLevel);
+
+    if (handle == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw StreamBufferCreateException();
+#else
+        configASSERT(!"StreamBuffer Constructor Failed");
+#endif
+    }
+}
+
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+StreamBuffer::StreamBuffer( size_t bufferSize, 
+                            size_t triggerLevel,
+                            uint8_t *storage, 
+                            StaticStreamBuffer_t *streamBuffer)
+{
+    handle = xStreamBufferCreateStatic(bufferSize, triggerLevel, storage, streamBuffer);
+
+    if (handle == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw StreamBufferCreateException();
+#else
+        configASSERT(!"StreamBuffer Constructor Failed");
+#endif
+    }
+}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+
+StreamBuffer::~StreamBuffer()
+{
+    vStreamBufferDelete(handle);
+}
+
+
+size_t StreamBuffer::Send(const void *data, size_t length, TickType_t Timeout)
+{
+    return xStreamBufferSend(handle, data, length, Timeout);
+}
+
+
+size_t StreamBuffer::SendFromISR(   const void *data, 
+                                    size_t length, 
+                                    BaseType_t *pxHigherPriorityTaskWoken)
+{
+    return xStreamBufferSendFromISR(handle, data, length, pxHigherPriorityTaskWoken);
+}
+
+
+size_t StreamBuffer::Receive(void *data, size_t maxLength, TickType_t Timeout)
+{
+    return xStreamBufferReceive(handle, data, maxLength, Timeout);
+}
+
+
+size_t StreamBuffer::ReceiveFromISR(void *data, 
+                                    size_t maxLength, 
+                                    BaseType_t *pxHigherPriorityTaskWoken)
+{
+    return xStreamBufferReceiveFromISR(handle, data, maxLength, pxHigherPriorityTaskWoken);
+}
+
+
+bool StreamBuffer::SetTriggerLevel(size_t triggerLevel)
+{
+    BaseType_t success;
+
+    success = xStreamBufferSetTriggerLevel(handle, triggerLevel);
+
+    return success == pdTRUE ? true : false;
+}
+
+
+bool StreamBuffer::IsEmpty()
+{
+    return xStreamBufferIsEmpty(handle) == pdTRUE ? true : false;
+}
+
+
+bool StreamBuffer::IsFull()
+{
+    return xStreamBufferIsFull(handle) == pdTRUE ? true : false;
+}
+
+
+bool StreamBuffer::Reset()
+{
+    return xStreamBufferReset(handle) == pdPASS ? true : false;
+}
+
+
+size_t StreamBuffer::BytesAvailable()
+{
+    return xStreamBufferBytesAvailable(handle);
+}
+
+
+size_t StreamBuffer::SpacesAvailable()
+{
+    return xStreamBufferSpacesAvailable(handle);
+}
+
+
+MessageBuffer::MessageBuffer(size_t bufferSize)
+{
+    handle = xMessageBufferCreate(bufferSize);
+
+    if (handle == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw StreamBufferCreateException("(MessageBuffer)");
+#else
+        configASSERT(!"MessageBuffer Constructor Failed");
+#endif
+    }
+}
+
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+MessageBuffer::MessageBuffer(   size_t bufferSize, 
+                                uint8_t *storage, 
+                                StaticMessageBuffer_t *messageBuffer)
+{
+    handle = xMessageBufferCreateStatic(bufferSize, storage, messageBuffer);
+
+    if (handle == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+        throw StreamBufferCreateException("(MessageBuffer)");
+#else
+        configASSERT(!"MessageBuffer Constructor Failed");
+#endif
+    }
+}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+
+MessageBuffer::~MessageBuffer()
+{
+    vMessageBufferDelete(handle);
+}
+
+
+bool MessageBuffer::Send(const void *message, size_t length, TickType_t Timeout)
+{
+    //
+    //  A message is written whole or not at all.
+    //
+    return xMessageBufferSend(handle, message, length, Timeout) == length ? true : false;
+}
+
+
+bool MessageBuffer::SendFromISR(const void *message, 
+                                size_t length, 
+                                BaseType_t *pxHigherPriorityTaskWoken)
+{
+    size_t sent;
+
+    sent = xMessageBufferSendFromISR(handle, message, length, pxHigherPriorityTaskWoken);
+
+    return sent == length ? true : false;
+}
+
+
+size_t MessageBuffer::Receive(void *message, size_t maxLength, TickType_t Timeout)
+{
+    return xMessageBufferReceive(handle, message, maxLength, Timeout);
+}
+
+
+size_t MessageBuffer::ReceiveFromISR(   void *message, 
+                                        size_t maxLength, 
+                                        BaseType_t *pxHigherPriorityTaskWoken)
+{
+    return xMessageBufferReceiveFromISR(handle, message, maxLength, pxHigherPriorityTaskWoken);
+}
+
+
+bool MessageBuffer::IsEmpty()
+{
+    return xMessageBufferIsEmpty(handle) == pdTRUE ? true : false;
+}
+
+
+bool MessageBuffer::IsFull()
+{
+    return xMessageBufferIsFull(handle) == pdTRUE ? true : false;
+}
+
+
+bool MessageBuffer::Reset()
+{
+    return xMessageBufferReset(handle) == pdPASS ? true : false;
+}
+
+
+size_t MessageBuffer::SpacesAvailable()
+{
+    return xMessageBufferSpacesAvailable(handle);
+}
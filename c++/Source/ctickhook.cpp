@@ -48,7 +48,7 @@ using namespace std;
 using namespace cpp_freertos;
 
 
-list<TickHook *> TickHook::Callbacks;
+TickHook::CallbackList TickHook::Callbacks;
 
 
 TickHook::TickHook()
@@ -59,29 +59,59 @@ TickHook::TickHook()
 
 TickHook::~TickHook()
 {
+    //
+    //  Only unlink our node in the critical section, it's freed when 
+    //  removed goes out of scope, after interrupts are back on.
+    //
+    CallbackList removed;
+
     #ifdef ESP_PLATFORM
         portMUX_TYPE mux;
         taskENTER_CRITICAL(&mux);
-        Callbacks.remove(this);
+        Unlink(removed);
         taskEXIT_CRITICAL(&mux);
     #else
         taskENTER_CRITICAL();
-        Callbacks.remove(this);
+        Unlink(removed);
         taskEXIT_CRITICAL();
     #endif
 }
 
 
+void TickHook::Unlink(CallbackList &removed)
+{
+    CallbackList::iterator it = Callbacks.begin();
+
+    while (it != Callbacks.end()) {
+
+        CallbackList::iterator next = it;
+        ++next;
+
+        if (*it == this) {
+            removed.splice(removed.end(), Callbacks, it);
+        }
+
+        it = next;
+    }
+}
+
+
 void TickHook::Register()
 {
+    //
+    //  Allocate the list node before masking interrupts, then only 
+    //  link it in inside the critical section.
+    //
+    CallbackList added(1, this);
+
     #ifdef ESP_PLATFORM
         portMUX_TYPE mux;
         taskENTER_CRITICAL(&mux);
-        Callbacks.push_front(this);
+        Callbacks.splice(Callbacks.begin(), added);
         taskEXIT_CRITICAL(&mux);
     #else
         taskENTER_CRITICAL();
-        Callbacks.push_front(this);
+        Callbacks.splice(Callbacks.begin(), added);
         taskEXIT_CRITICAL();
     #endif
 }
@@ -124,7 +154,7 @@ void TickHook::Enable()
  */
 void vApplicationTickHook(void)
 {
-    for (list<TickHook *>::iterator it = TickHook::Callbacks.begin();
+    for (TickHook::CallbackList::iterator it = TickHook::Callbacks.begin();
          it != TickHook::Callbacks.end();
          ++it) {
 
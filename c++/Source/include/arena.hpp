@@ -0,0 +1,356 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef ARENA_HPP_
+#define ARENA_HPP_
+
+/**
+ *  C++ exceptions are used by default when constructors fail.
+ *  If you do not want this behavior, define the following in your makefile
+ *  or project. Note that in most / all cases when a constructor fails,
+ *  it's a fatal error. In the cases when you've defined this, the new
+ *  default behavior will be to issue a configASSERT() instead.
+ */
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+#include <exception>
+#include <string>
+#include <cstdio>
+#ifdef CPP_FREERTOS_NO_CPP_STRINGS
+#error "FreeRTOS-Addons require C++ Strings if you are using exceptions"
+#endif
+#endif
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "mem_pool.hpp"
+
+namespace cpp_freertos {
+
+
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+/**
+ *  This is the exception that is thrown if an Arena cannot get
+ *  its memory.
+ */
+class ArenaCreateException : public std::exception {
+
+    public:
+        /**
+         *  Create the exception.
+         */
+        ArenaCreateException()
+        {
+            sprintf(errorString, "Arena Create Failed");
+        }
+
+        /**
+         *  Get what happened as a string.
+         *  We are overriding the base implementation here.
+         */
+        virtual const char *what() const throw()
+        {
+            return errorString;
+        }
+
+    private:
+        /**
+         *  A text string representing what failed.
+         */
+        char errorString[80];
+};
+#endif
+
+
+/**
+ *  An Arena hands out memory of any size and alignment from a single
+ *  region by bumping an offset, and takes it all back at once with
+ *  Reset().
+ *
+ *  This is meant for work that allocates a lot of short lived objects
+ *  and then throws them all away together, such as one pass of a 
+ *  processing loop. Allocate() is a pointer increment, there is no 
+ *  per allocation free, and Reset() is O(1).
+ *
+ *  Nested lifetimes are handled with markers. GetMarker() remembers
+ *  how full the Arena is, and ResetToMarker() frees everything 
+ *  allocated since. ArenaScope does this automatically.
+ *
+ *  The region can be malloc'ed, passed in, or borrowed as one item
+ *  from a MemoryPool.
+ *
+ *  Destructors of objects placed in an Arena are not run, and an Arena
+ *  is not thread safe. The usual pattern is one Arena per task.
+ */
+class Arena {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  An opaque position in the Arena.
+         */
+        typedef int Marker;
+
+        /**
+         *  The alignment Allocate() uses if you don't give one. This 
+         *  is enough for any fundamental type on the targets we run on.
+         */
+        static const int DefaultAlignment = 2 * sizeof(void *);
+
+        /**
+         *  Constructor to create an Arena.
+         *
+         *  This constructor uses the system malloc to actually obtain
+         *  the memory.
+         *
+         *  @param size How many bytes the Arena holds.
+         *  @throws ArenaCreateException on failure.
+         */
+        explicit Arena(int size);
+
+        /**
+         *  Constructor to create an Arena.
+         *
+         *  This constructor uses memory you pass in to actually create
+         *  the Arena. This constructor does not throw.
+         *
+         *  @param buffer Pointer to the preallocated memory.
+         *  @param size How big is the buffer you are passing in.
+         */
+        Arena(void *buffer, int size);
+
+        /**
+         *  Constructor to create an Arena.
+         *
+         *  This constructor borrows one item from a MemoryPool, and
+         *  returns it when the Arena is destroyed.
+         *
+         *  @param pool The pool to take the region from.
+         *  @throws ArenaCreateException if the pool is empty.
+         */
+        explicit Arena(MemoryPool &pool);
+
+        /**
+         *  Our destructor. Gives back the region if we obtained it.
+         */
+        ~Arena();
+
+        /**
+         *  Allocate memory from the Arena.
+         *
+         *  @param size How many bytes.
+         *  @param alignment Power of 2 address boundary for the memory.
+         *  @return Pointer to the memory, or NULL if the Arena is full.
+         */
+        inline void *Allocate(int size, int alignment = DefaultAlignment);
+
+        /**
+         *  Free everything allocated from the Arena.
+         */
+        inline void Reset()
+        {
+            Offset = 0;
+        }
+
+        /**
+         *  Remember the current position in the Arena.
+         *
+         *  @return A marker for ResetToMarker().
+         */
+        inline Marker GetMarker()
+        {
+            return Offset;
+        }
+
+        /**
+         *  Free everything allocated since a call to GetMarker().
+         *
+         *  @param marker A marker from this Arena. Markers taken after
+         *  it are no longer valid.
+         */
+        void ResetToMarker(Marker marker);
+
+        /**
+         *  @return How many bytes are currently allocated, including 
+         *  any alignment padding.
+         */
+        inline int GetBytesUsed()
+        {
+            return Offset;
+        }
+
+        /**
+         *  @return How many bytes are left. Alignment padding can 
+         *  make less than this usable.
+         */
+        inline int GetBytesFree()
+        {
+            return Size - Offset;
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  Start of the region.
+         */
+        unsigned char *Buffer;
+
+        /**
+         *  Size of the region in bytes.
+         */
+        int Size;
+
+        /**
+         *  Offset of the first free byte in the region.
+         */
+        int Offset;
+
+        /**
+         *  Where the region came from, so we can give it back.
+         */
+        enum RegionSource {
+            FromMalloc,
+            FromCaller,
+            FromPool
+        } Source;
+
+        /**
+         *  The pool we borrowed the region from, if any.
+         */
+        MemoryPool *Pool;
+
+        /**
+         *  Arenas own memory, so they can't be copied.
+         */
+        Arena(const Arena &);
+        Arena &operator=(const Arena &);
+};
+
+
+inline void *Arena::Allocate(int size, int alignment)
+{
+    configASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    uintptr_t base = (uintptr_t)(Buffer + Offset);
+    int padding = (int)((alignment - (base & (alignment - 1))) & (alignment - 1));
+
+    if (size < 0 || padding + size > Size - Offset) {
+        return NULL;
+    }
+
+    void *memory = Buffer + Offset + padding;
+    Offset += padding + size;
+
+    return memory;
+}
+
+
+/**
+ *  Frees everything allocated from an Arena during the lifetime of
+ *  this object.
+ */
+class ArenaScope {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  Remember where the Arena is now.
+         *
+         *  @param arena The Arena to scope.
+         */
+        explicit ArenaScope(Arena &arena)
+            : ScopedArena(arena),
+              Start(arena.GetMarker())
+        {
+        }
+
+        /**
+         *  Free everything allocated since we were created.
+         */
+        ~ArenaScope()
+        {
+            ScopedArena.ResetToMarker(Start);
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  The Arena being scoped.
+         */
+        Arena &ScopedArena;
+
+        /**
+         *  Where it was when we started.
+         */
+        Arena::Marker Start;
+
+        /**
+         *  Scopes can't be copied.
+         */
+        ArenaScope(const ArenaScope &);
+        ArenaScope &operator=(const ArenaScope &);
+};
+
+
+}
+
+#endif
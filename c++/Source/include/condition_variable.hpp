@@ -45,6 +45,9 @@
 
 #include <list>
 #include "mutex.hpp"
+#ifdef CPP_FREERTOS_POOL_ALLOCATOR
+#include "pool_allocator.hpp"
+#endif
 
 
 /**
@@ -116,7 +119,11 @@ class ConditionVariable {
         /**
          *  Implementation of a wait list of Threads.
          */
+#ifdef CPP_FREERTOS_POOL_ALLOCATOR
+        std::list<Thread *, PoolAllocator<Thread *> > WaitList;
+#else
         std::list<Thread *> WaitList;
+#endif
 
         /**
          *  Internal helper function to queue a Thread to 
@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef LOCK_FREE_MEM_POOL_HPP_
+#define LOCK_FREE_MEM_POOL_HPP_
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "mem_pool.hpp"
+
+namespace cpp_freertos {
+
+
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+/**
+ *  This is the exception that is thrown if a LockFreeMemoryPool is 
+ *  asked to hold more items than its index can address.
+ */
+class MemoryPoolTooManyItemsException : public std::exception {
+
+    public:
+        /**
+         *  Create the exception.
+         */
+        MemoryPoolTooManyItemsException()
+        {
+            sprintf(errorString, "MemoryPool Too Many Items");
+        }
+
+        /**
+         *  Get what happened as a string.
+         *  We are overriding the base implementation here.
+         */
+        virtual const char *what() const throw()
+        {
+            return errorString;
+        }
+
+    private:
+        /**
+         *  A text string representing what failed.
+         */
+        char errorString[80];
+};
+#endif
+
+
+/**
+ *  Lock Free Memory Pools are fixed size allocations, like a MemoryPool,
+ *  but the free list is a Treiber stack managed with atomic compare 
+ *  and exchange operations instead of a Mutex.
+ *
+ *  Allocate() and Free() never block, and are safe to call from both 
+ *  task and ISR context. Unlike a MemoryPool, the OS does not need 
+ *  to be running.
+ *
+ *  Items live in a single contiguous buffer and are tracked by index.
+ *  The top of the stack is one word, half of which is a tag that changes
+ *  on every operation to prevent the ABA problem. As a result the number
+ *  of items is limited (65534 on 32 bit targets), and memory cannot be 
+ *  added after construction.
+ *
+ *  @note This requires the compiler's __atomic builtins, and a target
+ *  with a native compare and exchange on a pointer sized word for the
+ *  operations to be truly lock free.
+ */
+class LockFreeMemoryPool {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  Constructor to create a Lock Free Memory Pool.
+         *
+         *  This constructor uses the system malloc to actually obtain
+         *  the memory.
+         *
+         *  @param itemSize How big is each item you want to allocate.
+         *  @param itemCount How many items max do you want to allocate
+         *      at once.
+         *  @param Alignment Power of 2 value denoting on which address boundary the
+         *      memory will be aligned to. Must be at least sizeof(unsigned char *).
+         *  @throws MemoryPoolMallocException on failure.
+         *  @throws MemoryPoolBadAlignmentException on failure.
+         *  @throws MemoryPoolTooManyItemsException on failure.
+         */
+        LockFreeMemoryPool( int itemSize,
+                            int itemCount,
+                            int alignment);
+
+        /**
+         *  Constructor to create a Lock Free Memory Pool.
+         *
+         *  This constructor uses memory you pass in to actually create
+         *  the pool.
+         *
+         *  @param itemSize How big is each item you want to allocate.
+         *  @param preallocatedMemory Pointer to the preallocated memory
+         *  you are dedicating to this pool.
+         *  @param preallocatedMemorySize How big is the buffer you are
+         *  passing in.
+         *  @param Alignment Power of 2 value denoting on which address boundary the
+         *      memory will be aligned to. Must be at least sizeof(unsigned char *).
+         *  @throws MemoryPoolBadAlignmentException on failure.
+         *  @throws MemoryPoolTooManyItemsException on failure.
+         */
+        LockFreeMemoryPool( int itemSize,
+                            void *preallocatedMemory,
+                            int preallocatedMemorySize,
+                            int alignment);
+
+        /**
+         *  Allocate an item from the pool. 
+         *  This never blocks and may be called from an ISR.
+         *
+         *  @return Pointer of the memory or NULL if the pool is empty.
+         */
+        void *Allocate();
+
+        /**
+         *  Returns the item back to it's pool.
+         *  This never blocks and may be called from an ISR.
+         *
+         *  @note There is no checking that the item is actually
+         *  valid to be returned to this pool.
+         */
+        void Free(void *item);
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  Tagged index of the top free item. The low half holds the
+         *  index of the item plus one (0 means empty), the high half
+         *  holds the tag.
+         */
+        uintptr_t Top;
+
+        /**
+         *  The aligned beginning of the items.
+         */
+        unsigned char *Buffer;
+
+        /**
+         *  Size of each item, a multiple of the alignment.
+         */
+        int ItemSize;
+
+        /**
+         *  The overall alignment of an item.
+         */
+        int Alignment;
+
+        /**
+         *  Adjusts and validates the alignment argument
+         *  passed in the ctor.
+         */
+        void CalculateValidAlignment();
+
+        /**
+         *  Calculate the true item size, based on alignment.
+         */
+        void CalculateItemSize();
+
+        /**
+         *  Validates the item count before any memory is touched.
+         */
+        void ValidateItemCount(int itemCount);
+
+        /**
+         *  Link all of the items in the Buffer into the free stack.
+         */
+        void InitItems(int itemCount);
+
+//
+//  If we are using C++11 or later, take advantage of the
+//  newer features to find bugs.
+//
+#if __cplusplus >= 201103L
+        /**
+         *  To correctly delete a Memory Pool, we'd have to guarantee that
+         *  all allocations had been returned to us. We side step this issue
+         *  as well as all the associated overhead with supporting this by
+         *  not allowing destructors.
+         */
+        ~LockFreeMemoryPool() = delete;
+#else
+        /**
+         *  To correctly delete a Memory Pool, we'd have to guarantee that
+         *  all allocations had been returned to us. We side step this issue
+         *  by making the destructor private so it can't be accessed.
+         */
+        ~LockFreeMemoryPool();
+#endif
+};
+
+
+}
+
+#endif
+
@@ -58,9 +58,9 @@
 #error "FreeRTOS-Addons require C++ Strings if you are using exceptions"
 #endif
 #endif
-#include <list>
 #include "FreeRTOS.h"
-#include "mutex.hpp"
+#include "semphr.h"
+#include "critical.hpp"
 
 namespace cpp_freertos {
 
@@ -130,15 +130,76 @@ class MemoryPoolBadAlignmentException : public std::exception {
 #endif
 
 
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+/**
+ *  Snapshot of how full a MemoryPool is, and how full it has been.
+ *  Only available if CPP_FREERTOS_MEMORY_POOL_STATS is defined.
+ *
+ *  Items moved in bulk by a MemoryPoolCache are counted when they 
+ *  leave or return to the pool, not when a task allocates them out 
+ *  of its magazine.
+ */
+struct MemoryPoolStats {
+
+    /**
+     *  Total number of items the pool owns, free or not.
+     */
+    int TotalItems;
+
+    /**
+     *  Number of items currently free in the pool.
+     */
+    int FreeItems;
+
+    /**
+     *  The fewest free items the pool has ever had. If this is 
+     *  still comfortably above zero after a long run, the pool is 
+     *  bigger than it needs to be.
+     */
+    int LowWaterMark;
+
+    /**
+     *  The most items that have ever been allocated at once.
+     */
+    int PeakUsage;
+
+    /**
+     *  Total items handed out.
+     */
+    unsigned long Allocations;
+
+    /**
+     *  Total items returned.
+     */
+    unsigned long Frees;
+
+    /**
+     *  Allocations that returned NULL because the pool was empty.
+     */
+    unsigned long FailedAllocations;
+};
+#endif
+
+
 /**
  *  Memory Pools are fixed size allocations to prevent fragmentation.
  *
  *  This is a new feature to FreeRTOS Wrappers and is not in and of
  *  itself a wrapper.
  *
- *  Memory Pools are thread safe, but cannot be used in ISR context.
- *  The OS must be running, because these use Mutexes to protect internal
- *  data structures.
+ *  Memory Pools are thread safe, and can be used from ISR context
+ *  through the FromISR variants. Internal data structures are protected 
+ *  by short critical sections rather than a Mutex, so that a buffer 
+ *  can be allocated in an ISR and handed to a task with zero copies.
+ *
+ *  Free items are kept on an intrusive singly linked stack, where the
+ *  link lives inside the free item itself. Allocate() and Free() are
+ *  therefore O(1) and never touch the system heap.
+ *
+ *  Tasks may also block in Allocate(timeout) until an item is returned.
+ *  Each returned item wakes at most one blocked task, and the free 
+ *  paths only touch the underlying semaphore when a task is actually 
+ *  waiting.
  */
 class MemoryPool {
 
@@ -171,7 +232,8 @@ class MemoryPool {
          *  Constructor to create a Memory Pool.
          *
          *  This constructor uses memory you pass in to actually create
-         *  the pool. This constructor does not throw.
+         *  the pool. The only system heap allocation is the semaphore
+         *  used by Allocate(timeout).
          *
          *  @param itemSize How big is each item you want to allocate.
          *  @param preallocatedMemory Pointer to the preallocated memory
@@ -180,6 +242,7 @@ class MemoryPool {
          *  passing in.
          *  @param Alignment Power of 2 value denoting on which address boundary the
          *      memory will be aligned to. Must be at least sizeof(unsigned char *).
+         *  @throws MemoryPoolMallocException on failure.
          *  @throws MemoryPoolBadAlignmentException on failure.
          */
         MemoryPool( int itemSize,
@@ -217,6 +280,19 @@ class MemoryPool {
          */
         void *Allocate();
 
+        /**
+         *  Allocate an item from the pool, blocking if it is empty.
+         *
+         *  If the pool is empty, the calling task sleeps until another
+         *  task or ISR returns an item, or the timeout expires.
+         *  This cannot be used from ISR context.
+         *
+         *  @param timeout How long to wait for an item, in ticks.
+         *  0 is the same as Allocate(), portMAX_DELAY waits forever.
+         *  @return Pointer of the memory or NULL if the timeout expired.
+         */
+        void *Allocate(TickType_t timeout);
+
         /**
          *  Returns the item back to it's pool.
          *
@@ -225,6 +301,73 @@ class MemoryPool {
          */
         void Free(void *item);
 
+        /**
+         *  Allocate an item from the pool in ISR context.
+         *
+         *  @return Pointer of the memory or NULL if the pool is empty.
+         */
+        void *AllocateFromISR();
+
+        /**
+         *  Returns the item back to it's pool in ISR context.
+         *
+         *  @param item The item to return.
+         *  @param pxHigherPriorityTaskWoken If returning the item woke a
+         *  task blocked in Allocate(timeout) with a higher priority than
+         *  the interrupted task, this is set to pdTRUE. May be NULL.
+         *  @note There is no checking that the item is actually
+         *  valid to be returned to this pool.
+         */
+        void FreeFromISR(void *item, BaseType_t *pxHigherPriorityTaskWoken = NULL);
+
+        /**
+         *  Allocate up to count items from the pool in a single 
+         *  critical section, rather than one per item.
+         *
+         *  Interrupts are masked while the items are taken, so keep
+         *  count reasonably small.
+         *
+         *  @param items Array of at least count pointers to fill in.
+         *  @param count How many items are wanted.
+         *  @return How many items were actually allocated, these are
+         *  in items[0] up to items[return value - 1]. This can be less
+         *  than count if the pool runs out.
+         */
+        int AllocateBatch(void **items, int count);
+
+        /**
+         *  Returns count items back to the pool in a single critical
+         *  section, rather than one per item.
+         *
+         *  @param items Array of count items to free.
+         *  @param count How many items to free.
+         *  @note There is no checking that the items are actually
+         *  valid to be returned to this pool.
+         */
+        void FreeBatch(void **items, int count);
+
+        /**
+         *  Get the usable size of each item, after it has been rounded
+         *  up for alignment.
+         *
+         *  @return The item size in bytes.
+         */
+        inline int GetItemSize()
+        {
+            return ItemSize;
+        }
+
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+        /**
+         *  Get the pool statistics. This does not enter the pool's
+         *  critical section, each field is read atomically on its own,
+         *  so it is cheap enough to call from a monitoring task or ISR.
+         *
+         *  @param stats Where to put the snapshot.
+         */
+        void GetStats(MemoryPoolStats &stats);
+#endif
+
     /////////////////////////////////////////////////////////////////////////
     //
     //  Private API
@@ -233,11 +376,6 @@ class MemoryPool {
     /////////////////////////////////////////////////////////////////////////
     private:
 
-        /**
-         *  Standard Mutex to allow thread safety.
-         */
-        Mutex *Lock;
-
         /**
          *  Save the item size for additions.
          */
@@ -249,9 +387,95 @@ class MemoryPool {
         int Alignment;
 
         /**
-         *  All of the real work is done with STL lists.
+         *  A free item. While an item sits in the pool, its first
+         *  bytes hold the link to the next free item. Items are
+         *  always at least one alignment unit (and therefore at
+         *  least one pointer) in size, so this always fits.
+         */
+        struct FreeItem {
+
+            /**
+             *  The next free item, or NULL at the bottom of the stack.
+             */
+            FreeItem *Next;
+        };
+
+        /**
+         *  Top of the stack of free items.
          */
-        std::list<void *>FreeItems;
+        FreeItem *FreeItems;
+
+        /**
+         *  Given once for each task that must be woken because an 
+         *  item was returned.
+         */
+        SemaphoreHandle_t ItemFreed;
+
+        /**
+         *  How many tasks are blocked in Allocate(timeout) and have
+         *  not been woken yet. Protected by the critical section.
+         */
+        int Waiters;
+
+        /**
+         *  Claim up to count waiters to wake. Must be called from
+         *  inside the pool's critical section.
+         *
+         *  @return How many tasks need a wake up.
+         */
+        int ClaimWaiters(int count);
+
+        /**
+         *  Wake the tasks claimed by ClaimWaiters(), must be called 
+         *  outside of the critical section.
+         */
+        void WakeWaiters(int count);
+
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+        /**
+         *  Running statistics. Only ever written inside the pool's
+         *  critical section, and only ever with atomic stores, so 
+         *  GetStats() can read them without locking.
+         */
+        MemoryPoolStats Stats;
+#endif
+
+        /**
+         *  Statistics bookkeeping. These compile away to nothing 
+         *  unless CPP_FREERTOS_MEMORY_POOL_STATS is defined, and must
+         *  be called from inside the pool's critical section.
+         */
+        void StatsInit();
+        void StatsAdded(int count);
+        void StatsAllocated(int count);
+        void StatsFailed(int count);
+        void StatsFreed(int count);
+
+        /**
+         *  Link itemCount items starting at address into a chain,
+         *  then push the entire chain onto the free stack in a
+         *  single critical section.
+         */
+        void AddItems(unsigned char *address, int itemCount);
+
+        /**
+         *  Pop up to count items off of the free stack in a single
+         *  critical section. The items are returned still linked
+         *  together, NULL terminated. Interrupts are masked while the 
+         *  chain is walked, so keep count small.
+         *
+         *  @param count How many items are wanted.
+         *  @param tail Returns the last item in the chain.
+         *  @param popped Returns how many items are in the chain.
+         *  @return The first item in the chain, or NULL if empty.
+         */
+        FreeItem *PopChain(int count, FreeItem **tail, int *popped);
+
+        /**
+         *  Push an already linked chain of count items onto the free 
+         *  stack in a single critical section.
+         */
+        void PushChain(FreeItem *head, FreeItem *tail, int count);
 
         /**
          *  Adjusts and validates the alignment argument
@@ -285,10 +509,103 @@ class MemoryPool {
         ~MemoryPool();
 #endif
 
-
+    /**
+     *  The MemoryPoolCache moves whole chains of items in and out
+     *  of the pool, so give it access to the free stack.
+     */
+    friend class MemoryPoolCache;
 };
 
 
+inline int MemoryPool::ClaimWaiters(int count)
+{
+    int wake = Waiters < count ? Waiters : count;
+    Waiters -= wake;
+    return wake;
+}
+
+inline void MemoryPool::WakeWaiters(int count)
+{
+    while (count-- > 0) {
+        xSemaphoreGive(ItemFreed);
+    }
+}
+
+
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+
+inline void MemoryPool::StatsInit()
+{
+    Stats.TotalItems = 0;
+    Stats.FreeItems = 0;
+    Stats.LowWaterMark = 0;
+    Stats.PeakUsage = 0;
+    Stats.Allocations = 0;
+    Stats.Frees = 0;
+    Stats.FailedAllocations = 0;
+}
+
+inline void MemoryPool::StatsAdded(int count)
+{
+    //
+    //  Until the first allocation the low water mark simply
+    //  tracks how much memory the pool has been given.
+    //
+    if (Stats.Allocations == 0) {
+        __atomic_store_n(&Stats.LowWaterMark, Stats.FreeItems + count, __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&Stats.TotalItems, Stats.TotalItems + count, __ATOMIC_RELAXED);
+    __atomic_store_n(&Stats.FreeItems, Stats.FreeItems + count, __ATOMIC_RELAXED);
+}
+
+inline void MemoryPool::StatsAllocated(int count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    int freeItems = Stats.FreeItems - count;
+    int inUse = Stats.TotalItems - freeItems;
+
+    __atomic_store_n(&Stats.FreeItems, freeItems, __ATOMIC_RELAXED);
+    __atomic_store_n(&Stats.Allocations, Stats.Allocations + count, __ATOMIC_RELAXED);
+
+    if (freeItems < Stats.LowWaterMark) {
+        __atomic_store_n(&Stats.LowWaterMark, freeItems, __ATOMIC_RELAXED);
+    }
+
+    if (inUse > Stats.PeakUsage) {
+        __atomic_store_n(&Stats.PeakUsage, inUse, __ATOMIC_RELAXED);
+    }
+}
+
+inline void MemoryPool::StatsFailed(int count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    __atomic_store_n(&Stats.FailedAllocations, Stats.FailedAllocations + count, __ATOMIC_RELAXED);
+}
+
+inline void MemoryPool::StatsFreed(int count)
+{
+    __atomic_store_n(&Stats.FreeItems, Stats.FreeItems + count, __ATOMIC_RELAXED);
+    __atomic_store_n(&Stats.Frees, Stats.Frees + count, __ATOMIC_RELAXED);
+}
+
+#else
+
+inline void MemoryPool::StatsInit() {}
+inline void MemoryPool::StatsAdded(int) {}
+inline void MemoryPool::StatsAllocated(int) {}
+inline void MemoryPool::StatsFailed(int) {}
+inline void MemoryPool::StatsFreed(int) {}
+
+#endif
+
+
 }
 
 #endif
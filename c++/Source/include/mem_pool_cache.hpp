@@ -0,0 +1,350 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef MEM_POOL_CACHE_HPP_
+#define MEM_POOL_CACHE_HPP_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_pool.hpp"
+
+
+/**
+ *  The MemoryPoolCache keeps its per task state in a FreeRTOS thread
+ *  local storage pointer, so it's only available if your 
+ *  FreeRTOSConfig.h enables them.
+ */
+#if (configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0)
+
+
+namespace cpp_freertos {
+
+
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+/**
+ *  Snapshot of how well a MemoryPoolCache is doing.
+ *  Only available if CPP_FREERTOS_MEMORY_POOL_STATS is defined.
+ */
+struct MemoryPoolCacheStats {
+
+    /**
+     *  Total calls to Allocate().
+     */
+    unsigned long Allocations;
+
+    /**
+     *  Allocations satisfied from the calling task's magazines,
+     *  without touching the pool.
+     */
+    unsigned long AllocationHits;
+
+    /**
+     *  Total calls to Free().
+     */
+    unsigned long Frees;
+
+    /**
+     *  Frees absorbed by the calling task's magazines, without
+     *  touching the pool.
+     */
+    unsigned long FreeHits;
+
+    /**
+     *  How many times the underlying MemoryPool critical section was
+     *  entered.
+     */
+    unsigned long PoolLocks;
+
+    /**
+     *  How many pool critical sections the cache avoided compared
+     *  to calling the MemoryPool directly for every operation.
+     */
+    unsigned long PoolLocksSaved;
+};
+#endif
+
+
+/**
+ *  A per task magazine cache layered on top of a MemoryPool.
+ *
+ *  Each task using the cache owns up to two magazines, chains of at
+ *  most magazineSize free items. Allocate() and Free() work on the
+ *  calling task's magazines without any locking. Only when both are 
+ *  empty (or full) is a whole magazine exchanged with the MemoryPool, 
+ *  in a single pool critical section.
+ *
+ *  Items are interchangeable, so an item may be freed by a different
+ *  task than the one that allocated it. It simply lands in the freeing 
+ *  task's magazine, and flows back to the pool once that is full.
+ *
+ *  The cache can hold up to 2 * magazineSize items per task that the
+ *  pool itself doesn't see as free, so size the pool accordingly.
+ *
+ *  @note This can only be used from task context, never from an ISR.
+ *  @note Each MemoryPoolCache needs its own thread local storage index.
+ */
+class MemoryPoolCache {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  Constructor to create a MemoryPoolCache.
+         *
+         *  @param pool The MemoryPool this caches.
+         *  @param tlsIndex Which FreeRTOS thread local storage pointer
+         *      this cache may use in every task that calls it. Must be
+         *      less than configNUM_THREAD_LOCAL_STORAGE_POINTERS.
+         *  @param magazineSize How many items in a magazine.
+         */
+        MemoryPoolCache(MemoryPool &pool,
+                        BaseType_t tlsIndex,
+                        int magazineSize);
+
+        /**
+         *  Allocate an item, from the calling task's magazines if
+         *  possible, otherwise from the pool.
+         *
+         *  @return Pointer of the memory or NULL if the pool is empty.
+         */
+        void *Allocate();
+
+        /**
+         *  Free an item into the calling task's magazines.
+         *
+         *  @note There is no checking that the item is actually
+         *  valid to be returned to this pool.
+         */
+        void Free(void *item);
+
+        /**
+         *  Return all of the calling task's cached items to the pool
+         *  and release its cache state. A task should call this before
+         *  it is deleted. Calling Allocate() or Free() afterwards is
+         *  fine, a new cache is created.
+         */
+        void ReleaseTaskCache();
+
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+        /**
+         *  Get a snapshot of the cache statistics.
+         *
+         *  @param stats Where to put the statistics.
+         */
+        void GetStats(MemoryPoolCacheStats &stats);
+#endif
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  A magazine, a chain of free items.
+         */
+        struct Magazine {
+
+            /**
+             *  First item in the chain.
+             */
+            MemoryPool::FreeItem *Head;
+
+            /**
+             *  Last item in the chain, so it can be spliced in O(1).
+             */
+            MemoryPool::FreeItem *Tail;
+
+            /**
+             *  How many items in the chain.
+             */
+            int Count;
+        };
+
+        /**
+         *  The per task state, hung off of a thread local storage 
+         *  pointer.
+         */
+        struct TaskCache {
+
+            /**
+             *  The magazine we allocate from and free to.
+             */
+            Magazine Loaded;
+
+            /**
+             *  A spare, swapped with Loaded before going to the pool.
+             */
+            Magazine Previous;
+        };
+
+        /**
+         *  The pool backing this cache.
+         */
+        MemoryPool &Pool;
+
+        /**
+         *  Which thread local storage pointer we use.
+         */
+        BaseType_t TlsIndex;
+
+        /**
+         *  Items per magazine.
+         */
+        int MagazineSize;
+
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+        /**
+         *  Statistics, updated atomically. These are shared by every
+         *  task using the cache, which is why they are opt in.
+         */
+        unsigned long Allocations;
+        unsigned long AllocationHits;
+        unsigned long Frees;
+        unsigned long FreeHits;
+        unsigned long PoolLocks;
+#endif
+
+        /**
+         *  Get the calling task's cache, creating it if needed.
+         *
+         *  @return The cache, or NULL if one could not be created.
+         */
+        TaskCache *GetTaskCache();
+
+        /**
+         *  Statistics bookkeeping. These compile away to nothing 
+         *  unless CPP_FREERTOS_MEMORY_POOL_STATS is defined.
+         */
+        void StatsInit();
+        void StatsAllocated(bool hit);
+        void StatsFreed(bool hit);
+        void StatsPoolLocked();
+
+        /**
+         *  Swap two magazines.
+         */
+        static inline void Swap(Magazine &a, Magazine &b)
+        {
+            Magazine tmp = a;
+            a = b;
+            b = tmp;
+        }
+
+//
+//  If we are using C++11 or later, take advantage of the
+//  newer features to find bugs.
+//
+#if __cplusplus >= 201103L
+        /**
+         *  Tasks may still be holding cached items, and there's no 
+         *  way to reach into their thread local storage to get them 
+         *  back. So like the MemoryPool, no destructor.
+         */
+        ~MemoryPoolCache() = delete;
+#else
+        /**
+         *  Tasks may still be holding cached items, and there's no 
+         *  way to reach into their thread local storage to get them 
+         *  back. So like the MemoryPool, make the destructor private.
+         */
+        ~MemoryPoolCache();
+#endif
+};
+
+
+#ifdef CPP_FREERTOS_MEMORY_POOL_STATS
+
+inline void MemoryPoolCache::StatsInit()
+{
+    Allocations = 0;
+    AllocationHits = 0;
+    Frees = 0;
+    FreeHits = 0;
+    PoolLocks = 0;
+}
+
+inline void MemoryPoolCache::StatsAllocated(bool hit)
+{
+    __atomic_fetch_add(&Allocations, 1, __ATOMIC_RELAXED);
+
+    if (hit) {
+        __atomic_fetch_add(&AllocationHits, 1, __ATOMIC_RELAXED);
+    }
+}
+
+inline void MemoryPoolCache::StatsFreed(bool hit)
+{
+    __atomic_fetch_add(&Frees, 1, __ATOMIC_RELAXED);
+
+    if (hit) {
+        __atomic_fetch_add(&FreeHits, 1, __ATOMIC_RELAXED);
+    }
+}
+
+inline void MemoryPoolCache::StatsPoolLocked()
+{
+    __atomic_fetch_add(&PoolLocks, 1, __ATOMIC_RELAXED);
+}
+
+#else
+
+inline void MemoryPoolCache::StatsInit() {}
+inline void MemoryPoolCache::StatsAllocated(bool) {}
+inline void MemoryPoolCache::StatsFreed(bool) {}
+inline void MemoryPoolCache::StatsPoolLocked() {}
+
+#endif
+
+
+}
+
+#endif
+
+#endif
+
@@ -0,0 +1,331 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef MESSAGE_RING_HPP_
+#define MESSAGE_RING_HPP_
+
+/**
+ *  C++ exceptions are used by default when constructors fail.
+ *  If you do not want this behavior, define the following in your makefile
+ *  or project. Note that in most / all cases when a constructor fails,
+ *  it's a fatal error. In the cases when you've defined this, the new
+ *  default behavior will be to issue a configASSERT() instead.
+ */
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+#include <exception>
+#include <string>
+#include <cstdio>
+#ifdef CPP_FREERTOS_NO_CPP_STRINGS
+#error "FreeRTOS-Addons require C++ Strings if you are using exceptions"
+#endif
+#endif
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+namespace cpp_freertos {
+
+
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+/**
+ *  This is the exception that is thrown if a MessageRing cannot be
+ *  created.
+ */
+class MessageRingCreateException : public std::exception {
+
+    public:
+        /**
+         *  Create the exception.
+         */
+        MessageRingCreateException()
+        {
+            sprintf(errorString, "MessageRing Create Failed");
+        }
+
+        /**
+         *  Get what happened as a string.
+         *  We are overriding the base implementation here.
+         */
+        virtual const char *what() const throw()
+        {
+            return errorString;
+        }
+
+    private:
+        /**
+         *  A text string representing what failed.
+         */
+        char errorString[80];
+};
+#endif
+
+
+/**
+ *  A MessageRing passes variable length messages through one 
+ *  contiguous byte buffer without copying them.
+ *
+ *  The producer Reserve()s space, writes the message in place and
+ *  Commit()s it. The consumer Peek()s at the oldest message in place
+ *  and Release()s it when done. Each message costs one length word on
+ *  top of its data, rounded up to pointer alignment, and every message
+ *  pointer is pointer aligned. The largest message is a little under
+ *  half the ring, which guarantees it always fits once the ring drains.
+ *
+ *  A MessageRing has exactly one producer and one consumer. They may
+ *  be any mix of tasks and ISRs, and they never lock each other out.
+ *  Only one reservation can be outstanding at a time.
+ */
+class MessageRing {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  Constructor to create a MessageRing.
+         *
+         *  This constructor uses the system malloc to actually obtain
+         *  the buffer.
+         *
+         *  @param size How many bytes the ring holds, including the 
+         *  length words.
+         *  @throws MessageRingCreateException on failure.
+         */
+        explicit MessageRing(int size);
+
+        /**
+         *  Constructor to create a MessageRing.
+         *
+         *  This constructor uses memory you pass in for the buffer.
+         *
+         *  @param buffer Pointer to the preallocated memory, aligned to
+         *  at least sizeof(void *).
+         *  @param size How big is the buffer you are passing in.
+         *  @throws MessageRingCreateException on failure.
+         */
+        MessageRing(void *buffer, int size);
+
+        /**
+         *  Our destructor. Frees the buffer if we allocated it.
+         */
+        ~MessageRing();
+
+        /**
+         *  Reserve space for a message, waiting for the consumer to
+         *  release older messages if the ring is full.
+         *
+         *  @param size How many bytes the message needs.
+         *  @param Timeout Timeout in FreeRTOS ticks.
+         *  @return Where to write the message, or NULL on timeout or
+         *  if the message could never fit.
+         */
+        void *Reserve(int size, TickType_t Timeout = portMAX_DELAY);
+
+        /**
+         *  Reserve space for a message, from ISR context. Does not wait.
+         *
+         *  @param size How many bytes the message needs.
+         *  @return Where to write the message, or NULL if there is no 
+         *  room.
+         */
+        void *ReserveFromISR(int size);
+
+        /**
+         *  Publish the message written into the last reservation.
+         *
+         *  @param size The actual size of the message, which may be 
+         *  smaller than what was reserved.
+         */
+        void Commit(int size);
+
+        /**
+         *  Publish the message written into the last reservation, from
+         *  ISR context.
+         *
+         *  @param size The actual size of the message, which may be 
+         *  smaller than what was reserved.
+         *  @param pxHigherPriorityTaskWoken Set to pdTRUE if this 
+         *  unblocked a higher priority task.
+         */
+        void CommitFromISR(int size, BaseType_t *pxHigherPriorityTaskWoken = NULL);
+
+        /**
+         *  Look at the oldest message, waiting for one if the ring is 
+         *  empty. The message stays in the ring until Release().
+         *
+         *  @param size Receives the size of the message.
+         *  @param Timeout Timeout in FreeRTOS ticks.
+         *  @return The message, or NULL on timeout.
+         */
+        void *Peek(int &size, TickType_t Timeout = portMAX_DELAY);
+
+        /**
+         *  Look at the oldest message, from ISR context. Does not wait.
+         *
+         *  @param size Receives the size of the message.
+         *  @return The message, or NULL if the ring is empty.
+         */
+        void *PeekFromISR(int &size);
+
+        /**
+         *  Give the space used by the message from the last successful
+         *  peek back to the producer.
+         */
+        void Release();
+
+        /**
+         *  Give the space used by the message from the last successful
+         *  peek back to the producer, from ISR context.
+         *
+         *  @param pxHigherPriorityTaskWoken Set to pdTRUE if this 
+         *  unblocked a higher priority task.
+         */
+        void ReleaseFromISR(BaseType_t *pxHigherPriorityTaskWoken = NULL);
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  Everything in the ring is laid out in slots of this size. 
+         *  A message is one slot holding its length, followed by its 
+         *  data rounded up to whole slots.
+         */
+        static const int Slot = sizeof(void *);
+
+        /**
+         *  Length word telling the consumer the rest of the buffer is 
+         *  unused and the next message is at the start.
+         */
+        static const int Wrap = -1;
+
+        /**
+         *  Start of the ring.
+         */
+        unsigned char *Buffer;
+
+        /**
+         *  Size of the ring in bytes, a whole number of slots.
+         */
+        int Size;
+
+        /**
+         *  Did we malloc the buffer?
+         */
+        bool Allocated;
+
+        /**
+         *  Offset just past the last committed message. Only the 
+         *  producer writes this.
+         */
+        int Head;
+
+        /**
+         *  Offset of the oldest unreleased message. Only the consumer
+         *  writes this.
+         */
+        int Tail;
+
+        /**
+         *  Offset and size in bytes of the outstanding reservation.
+         */
+        int Reserved;
+        int ReservedSize;
+
+        /**
+         *  Size in bytes of the message from the last peek.
+         */
+        int PeekedSize;
+
+        /**
+         *  Set while a task is about to block, so the other side only
+         *  pays for a semaphore give when someone is waiting.
+         */
+        int ProducerWaiting;
+        int ConsumerWaiting;
+
+        /**
+         *  Given on release and commit, respectively.
+         */
+        SemaphoreHandle_t SpaceAvailable;
+        SemaphoreHandle_t DataAvailable;
+
+        /**
+         *  Shared by both constructors.
+         */
+        void Initialize();
+
+        /**
+         *  Can this message ever be reserved?
+         */
+        bool MessageFits(int size);
+
+        void *TryReserve(int size);
+        void *TryPeek(int &size);
+
+        /**
+         *  @return true if the other side needs waking up.
+         */
+        bool CommitInternal(int size);
+        bool ReleaseInternal();
+
+        static inline int RoundUp(int size)
+        {
+            return (size + Slot - 1) & ~(Slot - 1);
+        }
+
+        /**
+         *  MessageRings own memory, so they can't be copied.
+         */
+        MessageRing(const MessageRing &);
+        MessageRing &operator=(const MessageRing &);
+};
+
+
+}
+#endif
@@ -0,0 +1,567 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef MPMC_QUEUE_HPP_
+#define MPMC_QUEUE_HPP_
+
+#if __cplusplus < 201103L
+#error "MpmcQueue requires C++11 or later"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "critical.hpp"
+
+
+/**
+ *  The cache line size to keep the producers' and consumers' data
+ *  apart. Most Cortex-M parts have no data cache at all, so this only
+ *  matters on larger targets, and on the Linux port.
+ */
+#ifndef CPP_FREERTOS_CACHE_LINE_SIZE
+#define CPP_FREERTOS_CACHE_LINE_SIZE    64
+#endif
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  A bounded, lock free, multiple producer, multiple consumer queue.
+ *
+ *  Every slot carries a sequence number that says whose turn it is, 
+ *  so producers and consumers each claim a slot with one compare and 
+ *  swap on their own index, and never touch the kernel while the 
+ *  queue is neither empty nor full. Only a task that has to wait 
+ *  enters a critical section, to put itself on a wait list, and it 
+ *  then sleeps on its direct to task notification. A producer or 
+ *  consumer that makes progress wakes one waiter from the other side, 
+ *  which costs a fence and a load when nobody is waiting.
+ *
+ *  Enqueue() and Dequeue() behave like Queue's, so code that uses a 
+ *  Queue from several producers and consumers can switch over. Items 
+ *  come out in the order their slots were claimed. As with a Queue, 
+ *  the highest priority waiting task is woken first, and tasks of 
+ *  equal priority are woken in the order they started waiting. If 
+ *  INCLUDE_uxTaskPriorityGet is not 1, waiters are simply woken in 
+ *  the order they started waiting.
+ *
+ *  Blocking uses the calling task's notification value, so a task 
+ *  must not block here while also waiting on notifications for 
+ *  something else. A stray notification only costs an extra trip 
+ *  around the wait loop.
+ *
+ *  @tparam T The type of item, copied in and moved out.
+ *  @tparam N How many items the queue holds, a power of 2.
+ *  @note requires __atomic builtins
+ */
+template<typename T, size_t N>
+class MpmcQueue {
+
+    static_assert(N >= 2 && (N & (N - 1)) == 0, 
+                  "MpmcQueue size must be a power of 2");
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  Create an empty queue. This does not allocate anything, so 
+         *  it can be done before the scheduler starts.
+         */
+        MpmcQueue()
+            : EnqueuePos(0),
+              DequeuePos(0)
+        {
+            for (size_t i = 0; i < N; i++) {
+                Cells[i].Sequence = i;
+            }
+        }
+
+        /**
+         *  Add an item to the back of the queue.
+         *
+         *  @param item The item you are adding.
+         *  @param Timeout How long to wait to add the item to the queue if
+         *         the queue is currently full.
+         *  @return true if the item was added, false if it was not.
+         */
+        bool Enqueue(const T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            while (true) {
+
+                if (TryEnqueue(item)) {
+                    NotEmpty.WakeOne();
+                    return true;
+                }
+
+                if (Timeout == 0) {
+                    return false;
+                }
+
+                Waiter waiter;
+                NotFull.Add(&waiter);
+
+                bool done = TryEnqueue(item);
+
+                if (!done) {
+                    ulTaskNotifyTake(pdTRUE, Timeout);
+                }
+
+                if (!NotFull.Remove(&waiter) && done) {
+                    //
+                    //  A consumer picked us, but we didn't need it. 
+                    //  Pass the wake up on so the space isn't lost.
+                    //
+                    NotFull.WakeOne();
+                }
+
+                if (done) {
+                    NotEmpty.WakeOne();
+                    return true;
+                }
+
+                if (xTaskCheckForTimeOut(&timeOut, &Timeout) != pdFALSE) {
+                    Timeout = 0;
+                }
+            }
+        }
+
+        /**
+         *  Remove an item from the front of the queue.
+         *
+         *  @param item Where the item you are removing will be returned to.
+         *  @param Timeout How long to wait to remove an item if the queue
+         *         is currently empty.
+         *  @return true if an item was removed, false if no item was removed.
+         */
+        bool Dequeue(T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            while (true) {
+
+                if (TryDequeue(item)) {
+                    NotFull.WakeOne();
+                    return true;
+                }
+
+                if (Timeout == 0) {
+                    return false;
+                }
+
+                Waiter waiter;
+                NotEmpty.Add(&waiter);
+
+                bool done = TryDequeue(item);
+
+                if (!done) {
+                    ulTaskNotifyTake(pdTRUE, Timeout);
+                }
+
+                if (!NotEmpty.Remove(&waiter) && done) {
+                    //
+                    //  A producer picked us, but we didn't need it. 
+                    //  Pass the wake up on so the item isn't stranded.
+                    //
+                    NotEmpty.WakeOne();
+                }
+
+                if (done) {
+                    NotFull.WakeOne();
+                    return true;
+                }
+
+                if (xTaskCheckForTimeOut(&timeOut, &Timeout) != pdFALSE) {
+                    Timeout = 0;
+                }
+            }
+        }
+
+        /**
+         *  Add an item to the back of the queue in ISR context.
+         *
+         *  @param item The item you are adding.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if the item was added, false if it was not.
+         */
+        bool EnqueueFromISR(const T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            if (!TryEnqueue(item)) {
+                return false;
+            }
+
+            NotEmpty.WakeOneFromISR(pxHigherPriorityTaskWoken);
+            return true;
+        }
+
+        /**
+         *  Remove an item from the front of the queue in ISR context.
+         *
+         *  @param item Where the item you are removing will be returned to.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if an item was removed, false if no item was removed.
+         */
+        bool DequeueFromISR(T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            if (!TryDequeue(item)) {
+                return false;
+            }
+
+            NotFull.WakeOneFromISR(pxHigherPriorityTaskWoken);
+            return true;
+        }
+
+        /**
+         *  Is the queue empty?
+         *  @return true if the queue was empty when this was called, false if
+         *  the queue was not empty.
+         */
+        inline bool IsEmpty() const
+        {
+            return NumItems() == 0;
+        }
+
+        /**
+         *  Is the queue full?
+         *  @return true if the queue was full when this was called, false if
+         *  the queue was not full.
+         */
+        inline bool IsFull() const
+        {
+            return NumItems() == N;
+        }
+
+        /**
+         *  How many items are currently in the queue. Slots that have
+         *  been claimed but not yet filled or emptied count as in use.
+         *  @return the number of items in the queue.
+         */
+        inline UBaseType_t NumItems() const
+        {
+            size_t dequeuePos = __atomic_load_n(&DequeuePos, __ATOMIC_ACQUIRE);
+            size_t enqueuePos = __atomic_load_n(&EnqueuePos, __ATOMIC_ACQUIRE);
+            size_t n = enqueuePos - dequeuePos;
+
+            //
+            //  The two loads aren't atomic together, so clamp.
+            //
+            if ((intptr_t)n < 0) {
+                n = 0;
+            }
+            else if (n > N) {
+                n = N;
+            }
+
+            return (UBaseType_t)n;
+        }
+
+        /**
+         *  How many empty spaces are currently left in the queue.
+         *  @return the number of remaining spaces.
+         */
+        inline UBaseType_t NumSpacesLeft() const
+        {
+            return (UBaseType_t)(N - NumItems());
+        }
+
+        MpmcQueue(const MpmcQueue &) = delete;
+        MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        static const size_t Mask = N - 1;
+
+        /**
+         *  A slot is free for the producer at position pos when its 
+         *  Sequence is pos, and holds an item for the consumer at 
+         *  position pos when its Sequence is pos + 1.
+         */
+        struct Cell {
+            size_t Sequence;
+            T Data;
+        };
+
+        /**
+         *  A task waiting on one side of the queue. These live on the 
+         *  waiting task's stack.
+         */
+        struct Waiter {
+            TaskHandle_t Task;
+            UBaseType_t Priority;
+            Waiter *Next;
+        };
+
+        /**
+         *  The tasks waiting for the queue to become not empty, or not 
+         *  full, highest priority first, then in the order they started
+         *  waiting.
+         */
+        class WaitList {
+
+            public:
+
+                WaitList()
+                    : Head(NULL),
+                      Count(0)
+                {
+                }
+
+                /**
+                 *  Put the calling task on the list. Once this returns,
+                 *  anyone who makes progress will see it.
+                 */
+                void Add(Waiter *waiter)
+                {
+                    waiter->Task = xTaskGetCurrentTaskHandle();
+#if (INCLUDE_uxTaskPriorityGet == 1)
+                    waiter->Priority = uxTaskPriorityGet(NULL);
+#else
+                    waiter->Priority = 0;
+#endif
+
+                    CriticalSection::Enter();
+
+                    //
+                    //  Go behind everyone of the same or higher priority.
+                    //
+                    Waiter **link = &Head;
+                    while (*link != NULL && (*link)->Priority >= waiter->Priority) {
+                        link = &(*link)->Next;
+                    }
+                    waiter->Next = *link;
+                    *link = waiter;
+                    __atomic_store_n(&Count, Count + 1, __ATOMIC_RELAXED);
+
+                    CriticalSection::Exit();
+
+                    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                }
+
+                /**
+                 *  Take the waiter back off the list.
+                 *
+                 *  @return true if it was still there, false if someone 
+                 *  already took it off to wake it.
+                 */
+                bool Remove(Waiter *waiter)
+                {
+                    bool found = false;
+
+                    CriticalSection::Enter();
+
+                    for (Waiter **link = &Head; *link != NULL; link = &(*link)->Next) {
+                        if (*link == waiter) {
+                            *link = waiter->Next;
+                            __atomic_store_n(&Count, Count - 1, __ATOMIC_RELAXED);
+                            found = true;
+                            break;
+                        }
+                    }
+
+                    CriticalSection::Exit();
+
+                    return found;
+                }
+
+                void WakeOne()
+                {
+                    if (!AnyWaiting()) {
+                        return;
+                    }
+
+                    CriticalSection::Enter();
+                    TaskHandle_t task = Claim();
+                    CriticalSection::Exit();
+
+                    if (task != NULL) {
+                        xTaskNotifyGive(task);
+                    }
+                }
+
+                void WakeOneFromISR(BaseType_t *pxHigherPriorityTaskWoken)
+                {
+                    if (!AnyWaiting()) {
+                        return;
+                    }
+
+                    BaseType_t savedInterruptStatus = CriticalSection::EnterFromISR();
+                    TaskHandle_t task = Claim();
+                    CriticalSection::ExitFromISR(savedInterruptStatus);
+
+                    if (task != NULL) {
+                        vTaskNotifyGiveFromISR(task, pxHigherPriorityTaskWoken);
+                    }
+                }
+
+            private:
+
+                Waiter *Head;
+                UBaseType_t Count;
+
+                /**
+                 *  Pairs with the fence in Add(), either the waiter sees
+                 *  our item or slot, or we see the waiter.
+                 */
+                inline bool AnyWaiting()
+                {
+                    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                    return __atomic_load_n(&Count, __ATOMIC_RELAXED) != 0;
+                }
+
+                /**
+                 *  Must be called inside a critical section.
+                 */
+                inline TaskHandle_t Claim()
+                {
+                    Waiter *waiter = Head;
+
+                    if (waiter == NULL) {
+                        return NULL;
+                    }
+
+                    Head = waiter->Next;
+                    __atomic_store_n(&Count, Count - 1, __ATOMIC_RELAXED);
+
+                    return waiter->Task;
+                }
+        };
+
+        /**
+         *  Each index and each wait list gets a line of its own. The 
+         *  wait lists are only written by tasks that block, and read 
+         *  by everyone who makes progress, so they shouldn't share a 
+         *  line with an index that every claim writes.
+         */
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) size_t EnqueuePos;
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) WaitList NotFull;
+
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) size_t DequeuePos;
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) WaitList NotEmpty;
+
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) Cell Cells[N];
+
+        bool TryEnqueue(const T &item)
+        {
+            Cell *cell;
+            size_t pos = __atomic_load_n(&EnqueuePos, __ATOMIC_RELAXED);
+
+            while (true) {
+
+                cell = &Cells[pos & Mask];
+                size_t seq = __atomic_load_n(&cell->Sequence, __ATOMIC_ACQUIRE);
+                intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+
+                if (dif == 0) {
+                    if (__atomic_compare_exchange_n(&EnqueuePos, &pos, pos + 1, true,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                        break;
+                    }
+                }
+                else if (dif < 0) {
+                    return false;
+                }
+                else {
+                    pos = __atomic_load_n(&EnqueuePos, __ATOMIC_RELAXED);
+                }
+            }
+
+            cell->Data = item;
+            __atomic_store_n(&cell->Sequence, pos + 1, __ATOMIC_RELEASE);
+
+            return true;
+        }
+
+        bool TryDequeue(T &item)
+        {
+            Cell *cell;
+            size_t pos = __atomic_load_n(&DequeuePos, __ATOMIC_RELAXED);
+
+            while (true) {
+
+                cell = &Cells[pos & Mask];
+                size_t seq = __atomic_load_n(&cell->Sequence, __ATOMIC_ACQUIRE);
+                intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+
+                if (dif == 0) {
+                    if (__atomic_compare_exchange_n(&DequeuePos, &pos, pos + 1, true,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                        break;
+                    }
+                }
+                else if (dif < 0) {
+                    return false;
+                }
+                else {
+                    pos = __atomic_load_n(&DequeuePos, __ATOMIC_RELAXED);
+                }
+            }
+
+            item = std::move(cell->Data);
+            __atomic_store_n(&cell->Sequence, pos + N, __ATOMIC_RELEASE);
+
+            return true;
+        }
+};
+
+
+}
+
+#endif
@@ -0,0 +1,423 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef OVERWRITING_QUEUE_HPP_
+#define OVERWRITING_QUEUE_HPP_
+
+#if __cplusplus < 201103L
+#error "OverwritingQueue requires C++11 or later"
+#endif
+
+#include <stddef.h>
+#include <type_traits>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+#include "critical.hpp"
+#include "queue.hpp"
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  A bounded queue that never makes producers wait. When it is full, 
+ *  Enqueue() throws away the oldest item to make room, and counts it.
+ *
+ *  This suits telemetry and sensor samples, where the newest data 
+ *  matters most and a hot path must not stall because a consumer fell 
+ *  behind. An Enqueue() is a copy of T inside a short critical section, 
+ *  plus a semaphore give only when a consumer is actually blocked 
+ *  waiting, so its cost does not depend on how full the queue is. 
+ *  That copy runs with interrupts masked, and from ISRs too, so T has 
+ *  to be trivially copyable, it can't allocate or free on the way in 
+ *  or out.
+ *
+ *  Consumers block in Dequeue() or DequeueMany(). Blocked consumers are 
+ *  counted, and each Enqueue() wakes at most one of them.
+ *
+ *  @tparam T The type of item, it must be trivially copyable.
+ *  @tparam N Maximum number of items the queue holds.
+ */
+template<typename T, size_t N>
+class OverwritingQueue {
+
+    static_assert(N > 0, "OverwritingQueue must hold at least one item");
+
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "OverwritingQueue copies items with interrupts masked, T must be trivially copyable");
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+        /**
+         *  Our constructor.
+         *
+         *  @throws QueueCreateException
+         */
+        OverwritingQueue()
+            : Head(0),
+              Count(0),
+              Waiters(0),
+              Drops(0)
+        {
+            //
+            //  The semaphore is never given more times than there are
+            //  blocked consumers, so any limit above the task count works.
+            //
+            ItemAdded = xSemaphoreCreateCounting(0x7FFF, 0);
+
+            if (ItemAdded == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+                throw QueueCreateException("OverwritingQueue");
+#else
+                configASSERT(!"OverwritingQueue Constructor Failed");
+#endif
+            }
+        }
+
+        /**
+         *  Our destructor.
+         */
+        ~OverwritingQueue()
+        {
+            vSemaphoreDelete(ItemAdded);
+        }
+
+        /**
+         *  Add an item to the back of the queue. This never blocks.
+         *
+         *  @param item The item you are adding.
+         *  @return true if there was room, false if the oldest item 
+         *          was dropped to make room.
+         */
+        bool Enqueue(const T &item)
+        {
+            CriticalSection::Enter();
+            bool fit = Push(item);
+            bool wake = ClaimWaiter();
+            CriticalSection::Exit();
+
+            if (wake) {
+                xSemaphoreGive(ItemAdded);
+            }
+
+            return fit;
+        }
+
+        /**
+         *  Add an item to the back of the queue in ISR context.
+         *
+         *  @param item The item you are adding.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if there was room, false if the oldest item 
+         *          was dropped to make room.
+         */
+        bool EnqueueFromISR(const T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            BaseType_t savedInterruptStatus = CriticalSection::EnterFromISR();
+            bool fit = Push(item);
+            bool wake = ClaimWaiter();
+            CriticalSection::ExitFromISR(savedInterruptStatus);
+
+            if (wake) {
+                xSemaphoreGiveFromISR(ItemAdded, pxHigherPriorityTaskWoken);
+            }
+
+            return fit;
+        }
+
+        /**
+         *  Remove the oldest item from the queue.
+         *
+         *  @param item Where the item you are removing will be returned to.
+         *  @param Timeout How long to wait to remove an item if the queue
+         *         is currently empty.
+         *  @return true if an item was removed, false if no item was removed.
+         */
+        bool Dequeue(T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            return DequeueMany(&item, 1, Timeout) == 1;
+        }
+
+        /**
+         *  Remove up to maxItems of the oldest items from the queue. 
+         *  This waits for the first item only, then takes whatever else 
+         *  is already there, so a burst costs a single wake up. Each 
+         *  item is taken in its own short critical section, so a large 
+         *  maxItems never holds off interrupts any longer than one item.
+         *
+         *  @param items Where the items will be returned to, oldest first.
+         *  @param maxItems The most items to remove.
+         *  @param Timeout How long to wait for the first item if the 
+         *         queue is currently empty.
+         *  @return How many items were removed, 0 on timeout.
+         */
+        size_t DequeueMany(T *items, size_t maxItems, TickType_t Timeout = portMAX_DELAY)
+        {
+            if (maxItems == 0) {
+                return 0;
+            }
+
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            while (true) {
+
+                CriticalSection::Enter();
+
+                bool got = (Count > 0);
+
+                if (got) {
+                    Pop(items[0]);
+                }
+                else if (Timeout != 0) {
+                    Waiters++;
+                }
+
+                CriticalSection::Exit();
+
+                if (got) {
+                    size_t n = 1;
+
+                    while (n < maxItems && TryPop(items[n])) {
+                        n++;
+                    }
+
+                    return n;
+                }
+
+                if (Timeout == 0) {
+                    return 0;
+                }
+
+                if (xSemaphoreTake(ItemAdded, Timeout) == pdTRUE) {
+                    //
+                    //  Something was added, but another consumer may 
+                    //  still beat us to it, so go around again.
+                    //
+                    if (xTaskCheckForTimeOut(&timeOut, &Timeout) != pdFALSE) {
+                        Timeout = 0;
+                    }
+                    continue;
+                }
+
+                //
+                //  Timed out. Take ourselves off the waiter count, unless 
+                //  an enqueue already claimed us, in which case its give 
+                //  is on the way and has to be consumed to keep the 
+                //  semaphore balanced.
+                //
+                CriticalSection::Enter();
+
+                bool claimed = (Waiters == 0);
+                if (!claimed) {
+                    Waiters--;
+                }
+
+                CriticalSection::Exit();
+
+                if (claimed) {
+                    xSemaphoreTake(ItemAdded, portMAX_DELAY);
+                }
+
+                //
+                //  One last non blocking try.
+                //
+                Timeout = 0;
+            }
+        }
+
+        /**
+         *  How many items have been dropped to make room since the 
+         *  queue was created.
+         *  @return the number of dropped items.
+         */
+        inline unsigned long Dropped()
+        {
+            return __atomic_load_n(&Drops, __ATOMIC_RELAXED);
+        }
+
+        /**
+         *  How many items are currently in the queue.
+         *  @return the number of items in the queue.
+         */
+        inline size_t NumItems()
+        {
+            return __atomic_load_n(&Count, __ATOMIC_RELAXED);
+        }
+
+        /**
+         *  Is the queue empty?
+         *  @return true if the queue was empty when this was called, false if
+         *  the queue was not empty.
+         */
+        inline bool IsEmpty()
+        {
+            return NumItems() == 0;
+        }
+
+        /**
+         *  Is the queue full? The next Enqueue() will drop an item.
+         *  @return true if the queue was full when this was called, false if
+         *  the queue was not full.
+         */
+        inline bool IsFull()
+        {
+            return NumItems() == N;
+        }
+
+        OverwritingQueue(const OverwritingQueue &) = delete;
+        OverwritingQueue &operator=(const OverwritingQueue &) = delete;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+        /**
+         *  Index of the oldest item.
+         */
+        size_t Head;
+
+        /**
+         *  How many items are in the queue.
+         */
+        size_t Count;
+
+        /**
+         *  How many consumers are blocked, or about to block, on 
+         *  ItemAdded and have not been claimed by an enqueue yet.
+         */
+        UBaseType_t Waiters;
+
+        unsigned long Drops;
+
+        SemaphoreHandle_t ItemAdded;
+
+        T Items[N];
+
+        /**
+         *  Must be called inside a critical section.
+         */
+        inline bool Push(const T &item)
+        {
+            size_t tail = Head + Count;
+            if (tail >= N) {
+                tail -= N;
+            }
+
+            Items[tail] = item;
+
+            if (Count < N) {
+                __atomic_store_n(&Count, Count + 1, __ATOMIC_RELAXED);
+                return true;
+            }
+
+            //
+            //  Full, so we just wrote over the oldest item.
+            //
+            if (++Head == N) {
+                Head = 0;
+            }
+            __atomic_store_n(&Drops, Drops + 1, __ATOMIC_RELAXED);
+
+            return false;
+        }
+
+        /**
+         *  Must be called inside a critical section, with Count > 0.
+         */
+        inline void Pop(T &item)
+        {
+            item = Items[Head];
+
+            if (++Head == N) {
+                Head = 0;
+            }
+            __atomic_store_n(&Count, Count - 1, __ATOMIC_RELAXED);
+        }
+
+        /**
+         *  Pop() in a critical section of its own.
+         *  @return true if there was an item.
+         */
+        inline bool TryPop(T &item)
+        {
+            CriticalSection::Enter();
+
+            bool got = (Count > 0);
+
+            if (got) {
+                Pop(item);
+            }
+
+            CriticalSection::Exit();
+
+            return got;
+        }
+
+        /**
+         *  Must be called inside a critical section.
+         *  @return true if a blocked consumer needs a give.
+         */
+        inline bool ClaimWaiter()
+        {
+            if (Waiters == 0) {
+                return false;
+            }
+
+            Waiters--;
+            return true;
+        }
+};
+
+
+}
+
+#endif
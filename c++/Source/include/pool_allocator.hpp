@@ -0,0 +1,304 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef POOL_ALLOCATOR_HPP_
+#define POOL_ALLOCATOR_HPP_
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_pool.hpp"
+
+
+/**
+ *  How many items a PoolAllocator grows its pool by each time the
+ *  pool runs dry. Override this in your makefile or project.
+ */
+#ifndef CPP_FREERTOS_POOL_ALLOCATOR_CHUNK
+#define CPP_FREERTOS_POOL_ALLOCATOR_CHUNK   8
+#endif
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  A standard library allocator backed by MemoryPools.
+ *
+ *  Node based containers such as std::list, std::set and std::map
+ *  allocate one node at a time, which is exactly what a MemoryPool
+ *  is good at. Containers rebind the allocator to their internal
+ *  node type, and every distinct type gets one shared pool sized for
+ *  it, created the first time it's needed. When a pool runs dry it 
+ *  grows by ItemsPerChunk items, and memory is never given back to 
+ *  the system heap, so a container that has reached its high water
+ *  mark never touches the heap again.
+ *
+ *  Requests for more than one object at a time (std::vector, 
+ *  std::deque) are passed straight through to the system heap.
+ *
+ *  All PoolAllocators of the same type share the same pool, so they
+ *  always compare equal and containers can freely swap and splice.
+ *
+ *  If you define CPP_FREERTOS_POOL_ALLOCATOR in your makefile or 
+ *  project, the wrapper library's own containers (the ConditionVariable
+ *  wait list and the TickHook callback list) use this allocator too,
+ *  and cmem_pool.cpp has to be part of your build.
+ *
+ *  Like MemoryPools, this is thread safe, but cannot be used in ISR 
+ *  context.
+ *
+ *  @tparam T The type of object to allocate.
+ *  @tparam ItemsPerChunk How many items to grow a pool by.
+ */
+template<typename T, int ItemsPerChunk = CPP_FREERTOS_POOL_ALLOCATOR_CHUNK>
+class PoolAllocator {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        typedef T value_type;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        /**
+         *  Containers use this to get an allocator for their nodes.
+         */
+        template<typename U>
+        struct rebind {
+            typedef PoolAllocator<U, ItemsPerChunk> other;
+        };
+
+        /**
+         *  PoolAllocators have no state of their own.
+         */
+        PoolAllocator() throw()
+        {
+        }
+
+        PoolAllocator(const PoolAllocator &) throw()
+        {
+        }
+
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U, ItemsPerChunk> &) throw()
+        {
+        }
+
+        pointer address(reference x) const
+        {
+            return &x;
+        }
+
+        const_pointer address(const_reference x) const
+        {
+            return &x;
+        }
+
+        /**
+         *  Get memory for n objects.
+         *
+         *  @param n How many objects.
+         *  @return The memory, never NULL.
+         *  @throws std::bad_alloc or MemoryPoolMallocException on 
+         *  failure.
+         */
+        pointer allocate(size_type n, const void * = 0)
+        {
+            void *p;
+
+            if (n == 1) {
+                p = Allocate();
+            }
+            else {
+                p = malloc(n * sizeof(T));
+            }
+
+            if (p == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+                throw std::bad_alloc();
+#else
+                configASSERT(!"PoolAllocator allocate Failed");
+#endif
+            }
+
+            return (pointer)p;
+        }
+
+        /**
+         *  Give back memory from allocate().
+         *
+         *  @param p The memory.
+         *  @param n How many objects it was allocated for.
+         */
+        void deallocate(pointer p, size_type n)
+        {
+            if (n == 1) {
+                GetPool()->Free(p);
+            }
+            else {
+                free(p);
+            }
+        }
+
+        size_type max_size() const throw()
+        {
+            return ((size_type)-1) / sizeof(T);
+        }
+
+        void construct(pointer p, const T &value)
+        {
+            new ((void *)p) T(value);
+        }
+
+        void destroy(pointer p)
+        {
+            p->~T();
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  The pool shared by every PoolAllocator of this type.
+         */
+        static MemoryPool *Pool;
+
+        /**
+         *  Get the shared pool, creating it if need be.
+         *
+         *  The scheduler is suspended rather than entering a critical
+         *  section, the same as the FreeRTOS heaps do, so that 
+         *  interrupts are not masked while the pool is malloc'ed.
+         *  A MemoryPool can't be deleted, so the pool is built while
+         *  suspended instead of building one up front and throwing 
+         *  away the loser of a race, and the scheduler is resumed 
+         *  before any exception from the MemoryPool goes any further.
+         */
+        static MemoryPool *GetPool()
+        {
+            MemoryPool *pool = __atomic_load_n(&Pool, __ATOMIC_ACQUIRE);
+
+            if (pool == NULL) {
+
+                vTaskSuspendAll();
+
+                pool = Pool;
+
+                if (pool == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+                    try {
+                        pool = new MemoryPool(sizeof(T), ItemsPerChunk, __alignof__(T));
+                    }
+                    catch (...) {
+                        xTaskResumeAll();
+                        throw;
+                    }
+#else
+                    pool = new MemoryPool(sizeof(T), ItemsPerChunk, __alignof__(T));
+#endif
+                    __atomic_store_n(&Pool, pool, __ATOMIC_RELEASE);
+                }
+
+                xTaskResumeAll();
+            }
+
+            return pool;
+        }
+
+        /**
+         *  Get one item from the shared pool, growing it if it's empty.
+         */
+        static void *Allocate()
+        {
+            MemoryPool *pool = GetPool();
+
+            void *p = pool->Allocate();
+
+            if (p == NULL) {
+                pool->AddMemory(ItemsPerChunk);
+                p = pool->Allocate();
+            }
+
+            return p;
+        }
+};
+
+
+template<typename T, int ItemsPerChunk>
+MemoryPool *PoolAllocator<T, ItemsPerChunk>::Pool = NULL;
+
+
+template<typename T, typename U, int ItemsPerChunk>
+inline bool operator==( const PoolAllocator<T, ItemsPerChunk> &, 
+                        const PoolAllocator<U, ItemsPerChunk> &)
+{
+    return true;
+}
+
+
+template<typename T, typename U, int ItemsPerChunk>
+inline bool operator!=( const PoolAllocator<T, ItemsPerChunk> &, 
+                        const PoolAllocator<U, ItemsPerChunk> &)
+{
+    return false;
+}
+
+
+}
+
+#endif
@@ -0,0 +1,381 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef PRIORITY_QUEUE_HPP_
+#define PRIORITY_QUEUE_HPP_
+
+#if __cplusplus < 201103L
+#error "PriorityQueue requires C++11 or later"
+#endif
+
+#include <stddef.h>
+#include <functional>
+#include <type_traits>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "critical.hpp"
+#include "queue.hpp"
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  A bounded queue that hands out items in priority order.
+ *
+ *  Items are kept in a binary heap in storage inside the object, so 
+ *  Enqueue() and Dequeue() are O(log N) and nothing is allocated per 
+ *  item. Like std::priority_queue, the item that compares greatest 
+ *  comes out first, so with the default std::less a bigger T is more 
+ *  urgent. Items that compare equal come out in no particular order.
+ *
+ *  Waiting is done on a pair of counting semaphores, one counting 
+ *  items and one counting free slots, so blocked tasks are woken by 
+ *  the kernel in their priority order, the same as with Queue. The 
+ *  heap itself is updated inside a critical section, which is held for 
+ *  at most log2(N) copies of a T and calls to Compare, also from the 
+ *  FromISR calls. So T has to be trivially copyable, and Compare must 
+ *  not allocate, block or do anything else that isn't safe with 
+ *  interrupts masked. Keep T small if you care about interrupt latency.
+ *
+ *  @tparam T The type of item, it must be trivially copyable.
+ *  @tparam N Maximum number of items the queue can hold.
+ *  @tparam Compare Strict weak ordering, Compare(a, b) is true if a 
+ *          comes out after b. Must be safe to call from an ISR.
+ */
+template<typename T, size_t N, typename Compare = std::less<T> >
+class PriorityQueue {
+
+    static_assert(N > 0, "PriorityQueue must hold at least one item");
+
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "PriorityQueue copies items with interrupts masked, T must be trivially copyable");
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+        /**
+         *  Our constructor.
+         *
+         *  @throws QueueCreateException
+         *  @param compare The comparison to order items with.
+         */
+        explicit PriorityQueue(const Compare &compare = Compare())
+            : Count(0),
+              Less(compare)
+        {
+            ItemsAvailable = xSemaphoreCreateCounting(N, 0);
+            SpacesAvailable = xSemaphoreCreateCounting(N, N);
+
+            if (ItemsAvailable == NULL || SpacesAvailable == NULL) {
+                if (ItemsAvailable != NULL) {
+                    vSemaphoreDelete(ItemsAvailable);
+                }
+                if (SpacesAvailable != NULL) {
+                    vSemaphoreDelete(SpacesAvailable);
+                }
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+                throw QueueCreateException("PriorityQueue Constructor Failed");
+#else
+                configASSERT(!"PriorityQueue Constructor Failed");
+#endif
+            }
+        }
+
+        /**
+         *  Our destructor.
+         */
+        ~PriorityQueue()
+        {
+            vSemaphoreDelete(ItemsAvailable);
+            vSemaphoreDelete(SpacesAvailable);
+        }
+
+        /**
+         *  Add an item to the queue, in priority order.
+         *
+         *  @param item The item you are adding.
+         *  @param Timeout How long to wait to add the item to the queue if
+         *         the queue is currently full.
+         *  @return true if the item was added, false if it was not.
+         */
+        bool Enqueue(const T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            if (xSemaphoreTake(SpacesAvailable, Timeout) != pdTRUE) {
+                return false;
+            }
+
+            CriticalSection::Enter();
+            Push(item);
+            CriticalSection::Exit();
+
+            xSemaphoreGive(ItemsAvailable);
+
+            return true;
+        }
+
+        /**
+         *  Remove the highest priority item from the queue.
+         *
+         *  @param item Where the item you are removing will be returned to.
+         *  @param Timeout How long to wait to remove an item if the queue
+         *         is currently empty.
+         *  @return true if an item was removed, false if no item was removed.
+         */
+        bool Dequeue(T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            if (xSemaphoreTake(ItemsAvailable, Timeout) != pdTRUE) {
+                return false;
+            }
+
+            CriticalSection::Enter();
+            Pop(item);
+            CriticalSection::Exit();
+
+            xSemaphoreGive(SpacesAvailable);
+
+            return true;
+        }
+
+        /**
+         *  Make a copy of the highest priority item. This will not 
+         *  remove it from the queue.
+         *
+         *  @param item Where the item will be copied to.
+         *  @return true if an item was copied, false if the queue is empty.
+         */
+        bool Peek(T &item)
+        {
+            bool found = false;
+
+            CriticalSection::Enter();
+
+            if (Count > 0) {
+                item = Heap[0];
+                found = true;
+            }
+
+            CriticalSection::Exit();
+
+            return found;
+        }
+
+        /**
+         *  Add an item to the queue, in priority order, in ISR context.
+         *
+         *  @param item The item you are adding.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if the item was added, false if it was not.
+         */
+        bool EnqueueFromISR(const T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            if (xSemaphoreTakeFromISR(SpacesAvailable, NULL) != pdTRUE) {
+                return false;
+            }
+
+            BaseType_t savedInterruptStatus = CriticalSection::EnterFromISR();
+            Push(item);
+            CriticalSection::ExitFromISR(savedInterruptStatus);
+
+            xSemaphoreGiveFromISR(ItemsAvailable, pxHigherPriorityTaskWoken);
+
+            return true;
+        }
+
+        /**
+         *  Remove the highest priority item from the queue in ISR context.
+         *
+         *  @param item Where the item you are removing will be returned to.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if an item was removed, false if no item was removed.
+         */
+        bool DequeueFromISR(T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            if (xSemaphoreTakeFromISR(ItemsAvailable, NULL) != pdTRUE) {
+                return false;
+            }
+
+            BaseType_t savedInterruptStatus = CriticalSection::EnterFromISR();
+            Pop(item);
+            CriticalSection::ExitFromISR(savedInterruptStatus);
+
+            xSemaphoreGiveFromISR(SpacesAvailable, pxHigherPriorityTaskWoken);
+
+            return true;
+        }
+
+        /**
+         *  Is the queue empty?
+         *  @return true if the queue was empty when this was called, false if
+         *  the queue was not empty.
+         */
+        inline bool IsEmpty()
+        {
+            return NumItems() == 0;
+        }
+
+        /**
+         *  Is the queue full?
+         *  @return true if the queue was full when this was called, false if
+         *  the queue was not full.
+         */
+        inline bool IsFull()
+        {
+            return NumItems() == N;
+        }
+
+        /**
+         *  How many items are currently in the queue. Items that are 
+         *  in the middle of being added or removed are not counted.
+         *  @return the number of items in the queue.
+         */
+        inline UBaseType_t NumItems()
+        {
+            return uxSemaphoreGetCount(ItemsAvailable);
+        }
+
+        /**
+         *  How many empty spaces are currently left in the queue.
+         *  @return the number of remaining spaces.
+         */
+        inline UBaseType_t NumSpacesLeft()
+        {
+            return uxSemaphoreGetCount(SpacesAvailable);
+        }
+
+        PriorityQueue(const PriorityQueue &) = delete;
+        PriorityQueue &operator=(const PriorityQueue &) = delete;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+        /**
+         *  Counts items in the heap that nobody has claimed yet.
+         */
+        SemaphoreHandle_t ItemsAvailable;
+
+        /**
+         *  Counts free slots in the heap that nobody has claimed yet.
+         */
+        SemaphoreHandle_t SpacesAvailable;
+
+        /**
+         *  How many items are actually in the heap.
+         */
+        size_t Count;
+
+        Compare Less;
+
+        /**
+         *  Heap[0] is the highest priority item, and the children of 
+         *  Heap[i] are Heap[2i + 1] and Heap[2i + 2].
+         */
+        T Heap[N];
+
+        /**
+         *  Must be called inside a critical section, with a slot claimed.
+         */
+        void Push(const T &item)
+        {
+            size_t i = Count++;
+
+            while (i > 0) {
+                size_t parent = (i - 1) / 2;
+                if (!Less(Heap[parent], item)) {
+                    break;
+                }
+                Heap[i] = Heap[parent];
+                i = parent;
+            }
+
+            Heap[i] = item;
+        }
+
+        /**
+         *  Must be called inside a critical section, with an item claimed.
+         */
+        void Pop(T &item)
+        {
+            item = Heap[0];
+
+            size_t n = --Count;
+            size_t i = 0;
+
+            if (n == 0) {
+                return;
+            }
+
+            //
+            //  Sift the last item down from the top.
+            //
+            while (true) {
+                size_t child = 2 * i + 1;
+                if (child >= n) {
+                    break;
+                }
+                if (child + 1 < n && Less(Heap[child], Heap[child + 1])) {
+                    child++;
+                }
+                if (!Less(Heap[n], Heap[child])) {
+                    break;
+                }
+                Heap[i] = Heap[child];
+                i = child;
+            }
+
+            Heap[i] = Heap[n];
+        }
+};
+
+
+}
+
+#endif
@@ -107,6 +107,87 @@ class QueueCreateException : public std::exception {
 #endif
 
 
+#ifdef CPP_FREERTOS_QUEUE_STATS
+
+/**
+ *  How many buckets the residency histogram has. Bucket 0 counts 
+ *  items that were dequeued within the tick they were enqueued in, 
+ *  bucket i counts items that waited from 2^(i-1) up to 2^i - 1 ticks, 
+ *  and the last bucket also takes everything longer.
+ */
+#ifndef CPP_FREERTOS_QUEUE_STATS_BUCKETS
+#define CPP_FREERTOS_QUEUE_STATS_BUCKETS    16
+#endif
+
+/**
+ *  To time how long each item spends in the queue, a tick count is 
+ *  stored alongside it, which means copying the item through a buffer 
+ *  on the stack. Queues of items bigger than this still keep all the 
+ *  other statistics, but leave the residency histogram empty.
+ */
+#ifndef CPP_FREERTOS_QUEUE_STATS_MAX_ITEM_SIZE
+#define CPP_FREERTOS_QUEUE_STATS_MAX_ITEM_SIZE  64
+#endif
+
+/**
+ *  Snapshot of how busy a Queue is, and how long things wait on it.
+ *  Only available if CPP_FREERTOS_QUEUE_STATS is defined.
+ *
+ *  Blocked times are measured in ticks from the start to the end of 
+ *  each Enqueue or Dequeue call, so a call that did not wait usually 
+ *  adds nothing. Peek() is not counted.
+ */
+struct QueueStats {
+
+    /**
+     *  The most items that have ever been in the queue at once. If 
+     *  this never gets near the queue size, the queue is bigger than 
+     *  it needs to be.
+     */
+    UBaseType_t PeakDepth;
+
+    /**
+     *  Total items added.
+     */
+    unsigned long Enqueues;
+
+    /**
+     *  Total items removed.
+     */
+    unsigned long Dequeues;
+
+    /**
+     *  Enqueue calls that waited for room and gave up. Calls that 
+     *  don't wait, including the FromISR ones, are not counted.
+     */
+    unsigned long EnqueueTimeouts;
+
+    /**
+     *  Dequeue calls that waited for an item and gave up. Calls that 
+     *  don't wait, including the FromISR ones, are not counted.
+     */
+    unsigned long DequeueTimeouts;
+
+    /**
+     *  Total ticks producers spent waiting for room.
+     */
+    unsigned long ProducerBlockedTicks;
+
+    /**
+     *  Total ticks consumers spent waiting for items.
+     */
+    unsigned long ConsumerBlockedTicks;
+
+    /**
+     *  How long items were in the queue, from the start of the 
+     *  Enqueue call to the Dequeue, in log2 sized buckets of ticks.
+     */
+    unsigned long Residency[CPP_FREERTOS_QUEUE_STATS_BUCKETS];
+};
+
+#endif
+
+
 /**
  *  Queue class wrapper for FreeRTOS queues. This class provides enqueue
  *  and dequeue operations.
@@ -177,6 +258,35 @@ class Queue {
          */
         bool Peek(void *item, TickType_t Timeout = portMAX_DELAY);
 
+        /**
+         *  Add several items to the back of the queue, in order.
+         *
+         *  @param items Array of items to add, each one the queue's 
+         *         item size.
+         *  @param count How many items are in the array.
+         *  @param Timeout How long to wait for room, for the whole batch.
+         *  @return How many items were added, starting from the first.
+         */
+        UBaseType_t EnqueueMany(const void *items, 
+                                UBaseType_t count, 
+                                TickType_t Timeout = portMAX_DELAY);
+
+        /**
+         *  Remove up to maxItems items from the front of the queue. 
+         *  This waits for the first item only, then takes whatever else 
+         *  is already there, so a burst costs a single wake up.
+         *
+         *  @param items Where the items will be returned to, room for
+         *         maxItems items of the queue's item size.
+         *  @param maxItems The most items to remove.
+         *  @param Timeout How long to wait for the first item if the 
+         *         queue is currently empty.
+         *  @return How many items were removed, 0 on timeout.
+         */
+        UBaseType_t DequeueMany(void *items, 
+                                UBaseType_t maxItems, 
+                                TickType_t Timeout = portMAX_DELAY);
+
         /**
          *  Add an item to the back of the queue in ISR context.
          *
@@ -237,6 +347,23 @@ class Queue {
          */
         UBaseType_t NumSpacesLeft();
 
+#ifdef CPP_FREERTOS_QUEUE_STATS
+        /**
+         *  Get the queue statistics. Each field is read atomically on 
+         *  its own, without locking, so it is cheap enough to call 
+         *  from a monitoring task or ISR.
+         *
+         *  @param stats Where to put the snapshot.
+         */
+        void GetStats(QueueStats &stats);
+
+        /**
+         *  Start the statistics over, for example at the start of a 
+         *  measurement. The peak depth restarts from the current depth.
+         */
+        void ResetStats();
+#endif
+
     /////////////////////////////////////////////////////////////////////////
     //
     //  Protected API
@@ -248,6 +375,47 @@ class Queue {
          *  FreeRTOS queue handle.
          */
         QueueHandle_t handle;
+
+        /**
+         *  Size of an item in the queue.
+         */
+        UBaseType_t itemSize;
+
+        /**
+         *  Every add and remove goes through these, so the statistics 
+         *  only have to be kept in one place. position is one of 
+         *  queueSEND_TO_BACK, queueSEND_TO_FRONT or queueOVERWRITE.
+         */
+        BaseType_t Send(const void *item, TickType_t Timeout, BaseType_t position);
+        BaseType_t SendFromISR( const void *item, 
+                                BaseType_t *pxHigherPriorityTaskWoken, 
+                                BaseType_t position);
+        BaseType_t Receive(void *item, TickType_t Timeout);
+        BaseType_t ReceiveFromISR(void *item, BaseType_t *pxHigherPriorityTaskWoken);
+
+#ifdef CPP_FREERTOS_QUEUE_STATS
+        /**
+         *  Whether items carry a tick count for the residency histogram.
+         */
+        bool timestamped;
+
+        /**
+         *  Running statistics, updated and read with atomics.
+         */
+        QueueStats statistics;
+
+        void StatsSent( BaseType_t success, 
+                        TickType_t Timeout, 
+                        TickType_t blocked, 
+                        UBaseType_t depth);
+        void StatsReceived(BaseType_t success, TickType_t Timeout, TickType_t blocked);
+        void StatsResidency(TickType_t ticks);
+#endif
+
+    /**
+     *  A QueueSet adds our handle to its kernel queue set.
+     */
+    friend class QueueSet;
 };
 
 
@@ -0,0 +1,329 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef QUEUE_SET_HPP_
+#define QUEUE_SET_HPP_
+
+/**
+ *  C++ exceptions are used by default when constructors fail.
+ *  If you do not want this behavior, define the following in your makefile
+ *  or project. Note that in most / all cases when a constructor fails,
+ *  it's a fatal error. In the cases when you've defined this, the new 
+ *  default behavior will be to issue a configASSERT() instead.
+ */
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+#include <exception>
+#include <cstdio>
+#include <string>
+#ifdef CPP_FREERTOS_NO_CPP_STRINGS
+#error "FreeRTOS-Addons require C++ Strings if you are using exceptions"
+#endif
+#endif
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "queue.hpp"
+#include "semaphore.hpp"
+#if __cplusplus >= 201103L
+#include "typed_queue.hpp"
+#endif
+
+
+#if( configUSE_QUEUE_SETS == 1 )
+
+namespace cpp_freertos {
+
+
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+/**
+ *  This is the exception that is thrown if a QueueSet constructor fails.
+ */
+class QueueSetCreateException : public std::exception {
+
+    public:
+        /**
+         *  Create the exception.
+         */
+        QueueSetCreateException()
+        {
+            sprintf(errorString, "QueueSet Constructor Failed");
+        }
+
+        /**
+         *  Get what happened as a string.
+         *  We are overriding the base implementation here.
+         */
+        virtual const char *what() const throw()
+        {
+            return errorString;
+        }
+
+    private:
+        /**
+         *  A text string representing what failed.
+         */
+        char errorString[80];
+};
+#endif
+
+
+/**
+ *  Wrapper for FreeRTOS queue sets, which let one task block on 
+ *  several queues and semaphores at once instead of polling them.
+ *
+ *  Select() returns which member has something waiting, and the task 
+ *  then reads that member as usual, with a zero timeout:
+ *
+ *      QueueSet::Member ready = set.Select();
+ *      if (ready == commands) {
+ *          commands.Dequeue(&command, 0);
+ *      }
+ *      else if (ready == tick) {
+ *          tick.Take(0);
+ *      }
+ *
+ *  Every item queued and every semaphore given posts one event to the
+ *  set, so the set must be created large enough to hold them all: the
+ *  sum of the lengths of the member queues plus the maximum counts of
+ *  the member semaphores. A member can only be added or removed while
+ *  it is empty, and members should only be read after being selected.
+ *
+ *  Requires configUSE_QUEUE_SETS.
+ */
+class QueueSet {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  Identifies the member that Select() found ready. Compare it 
+         *  against the members you added.
+         */
+        class Member {
+
+            public:
+
+                /**
+                 *  An empty Member, which matches nothing.
+                 */
+                Member()
+                    : Handle(NULL)
+                {
+                }
+
+                /**
+                 *  @return true if the select timed out, 
+                 *  and no member is ready.
+                 */
+                bool TimedOut() const
+                {
+                    return Handle == NULL;
+                }
+
+                bool operator==(Queue &queue) const
+                {
+                    return Handle != NULL && Handle == HandleOf(queue);
+                }
+
+                bool operator==(Semaphore &semaphore) const
+                {
+                    return Handle != NULL && Handle == HandleOf(semaphore);
+                }
+
+#if __cplusplus >= 201103L
+                template<typename T>
+                bool operator==(TypedQueue<T> &queue) const
+                {
+                    return Handle != NULL && Handle == HandleOf(queue);
+                }
+#endif
+
+            private:
+
+                explicit Member(QueueSetMemberHandle_t handle)
+                    : Handle(handle)
+                {
+                }
+
+                /**
+                 *  The kernel handle of the ready member.
+                 */
+                QueueSetMemberHandle_t Handle;
+
+            friend class QueueSet;
+        };
+
+        /**
+         *  Our constructor.
+         *
+         *  @throws QueueSetCreateException
+         *  @param maxEvents The total number of items and semaphore 
+         *  counts the members can hold between them.
+         */
+        explicit QueueSet(UBaseType_t maxEvents);
+
+        /**
+         *  Our destructor. Remove the members first.
+         */
+        ~QueueSet();
+
+        /**
+         *  Add a queue, deque or binary queue to the set.
+         *
+         *  @param queue The queue, which must be empty.
+         *  @return true if it was added, false if it was not.
+         */
+        bool Add(Queue &queue);
+
+        /**
+         *  Add a binary or counting semaphore to the set.
+         *
+         *  @param semaphore The semaphore, which must not be available.
+         *  @return true if it was added, false if it was not.
+         */
+        bool Add(Semaphore &semaphore);
+
+        /**
+         *  Take a queue out of the set.
+         *
+         *  @param queue The queue, which must be empty.
+         *  @return true if it was removed, false if it was not.
+         */
+        bool Remove(Queue &queue);
+
+        /**
+         *  Take a semaphore out of the set.
+         *
+         *  @param semaphore The semaphore, which must not be available.
+         *  @return true if it was removed, false if it was not.
+         */
+        bool Remove(Semaphore &semaphore);
+
+#if __cplusplus >= 201103L
+        /**
+         *  Add a TypedQueue, or anything built on one, to the set.
+         *
+         *  @param queue The queue, which must be empty.
+         *  @return true if it was added, false if it was not.
+         */
+        template<typename T>
+        bool Add(TypedQueue<T> &queue)
+        {
+            return xQueueAddToSet(HandleOf(queue), handle) == pdPASS;
+        }
+
+        /**
+         *  Take a TypedQueue out of the set.
+         *
+         *  @param queue The queue, which must be empty.
+         *  @return true if it was removed, false if it was not.
+         */
+        template<typename T>
+        bool Remove(TypedQueue<T> &queue)
+        {
+            return xQueueRemoveFromSet(HandleOf(queue), handle) == pdPASS;
+        }
+#endif
+
+        /**
+         *  Wait for any member to have something available.
+         *
+         *  @param Timeout How long to wait.
+         *  @return The ready member, check TimedOut() if you used a 
+         *  timeout.
+         */
+        Member Select(TickType_t Timeout = portMAX_DELAY);
+
+        /**
+         *  See if any member has something available, in ISR context.
+         *
+         *  @return The ready member, or one where TimedOut() is true.
+         */
+        Member SelectFromISR();
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  FreeRTOS queue set handle.
+         */
+        QueueSetHandle_t handle;
+
+        static inline QueueSetMemberHandle_t HandleOf(Queue &queue)
+        {
+            return queue.handle;
+        }
+
+        static inline QueueSetMemberHandle_t HandleOf(Semaphore &semaphore)
+        {
+            return semaphore.handle;
+        }
+
+#if __cplusplus >= 201103L
+        template<typename T>
+        static inline QueueSetMemberHandle_t HandleOf(TypedQueue<T> &queue)
+        {
+            return queue.handle;
+        }
+#endif
+
+        /**
+         *  Queue sets can't be copied.
+         */
+        QueueSet(const QueueSet &);
+        QueueSet &operator=(const QueueSet &);
+};
+
+
+}
+
+#endif /* configUSE_QUEUE_SETS */
+
+#endif
@@ -188,6 +188,11 @@ class Semaphore {
          *  directly created, this is a base class only.
          */
         Semaphore();
+
+    /**
+     *  A QueueSet adds our handle to its kernel queue set.
+     */
+    friend class QueueSet;
 };
 
 
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef SHARED_BUFFER_HPP_
+#define SHARED_BUFFER_HPP_
+
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "mem_pool.hpp"
+
+namespace cpp_freertos {
+
+
+/**
+ *  A reference counted handle to a buffer allocated from a MemoryPool.
+ *
+ *  This lets one buffer be handed to several consumers without copying
+ *  it. Copying a SharedBuffer adds a reference, destroying one drops a 
+ *  reference, and the buffer goes back to its pool when the last
+ *  reference is dropped. The count is updated with atomic operations,
+ *  so handles to the same buffer can live in different tasks.
+ *
+ *  FreeRTOS queues copy bytes, not objects, so a SharedBuffer cannot be
+ *  put in a Queue directly. Instead, Share() turns a new reference into
+ *  a plain pointer sized token that can be queued, and the receiver
+ *  turns it back into a SharedBuffer with Adopt(). To fan a buffer out 
+ *  to N queues, Share() it N times and then let the original go.
+ *
+ *  Every pool item carries a small header in front of the data, so
+ *  create the pool with an item size of HeaderSize plus the data size
+ *  you need. The data is aligned for any fundamental type as long as
+ *  the pool's alignment is at least 2 * sizeof(void *).
+ */
+class SharedBuffer {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  How many bytes at the front of each pool item are used
+         *  for bookkeeping.
+         */
+        static const int HeaderSize;
+
+        /**
+         *  Create an empty handle, not referring to any buffer.
+         */
+        SharedBuffer();
+
+        /**
+         *  Get a buffer from a pool, with a reference count of one.
+         *
+         *  @param pool The pool to allocate from.
+         *  @return A handle to the buffer, or an empty handle if the 
+         *  pool is empty.
+         */
+        static SharedBuffer Allocate(MemoryPool &pool);
+
+        /**
+         *  Get a buffer from a pool, blocking if the pool is empty.
+         *
+         *  @param pool The pool to allocate from.
+         *  @param timeout How long to wait for a buffer, in ticks.
+         *  @return A handle to the buffer, or an empty handle if the 
+         *  timeout expired.
+         */
+        static SharedBuffer Allocate(MemoryPool &pool, TickType_t timeout);
+
+        /**
+         *  Get a buffer from a pool in ISR context.
+         *
+         *  @param pool The pool to allocate from.
+         *  @return A handle to the buffer, or an empty handle if the 
+         *  pool is empty.
+         */
+        static SharedBuffer AllocateFromISR(MemoryPool &pool);
+
+        /**
+         *  Turn a token from Share() back into a handle. The handle
+         *  takes over the reference the token was holding.
+         *
+         *  @param token A token from Share() or Detach().
+         *  @return A handle to the buffer.
+         */
+        static SharedBuffer Adopt(void *token);
+
+        /**
+         *  Copying a handle adds a reference to the buffer.
+         */
+        SharedBuffer(const SharedBuffer &other);
+
+        /**
+         *  Assigning a handle drops our old reference, and adds a 
+         *  reference to the new buffer.
+         */
+        SharedBuffer &operator=(const SharedBuffer &other);
+
+#if __cplusplus >= 201103L
+        /**
+         *  Moving a handle takes the reference without touching the
+         *  count, and leaves the other handle empty.
+         */
+        SharedBuffer(SharedBuffer &&other) noexcept;
+
+        /**
+         *  Move assignment, drops our old reference and takes the
+         *  other handle's without touching its count.
+         */
+        SharedBuffer &operator=(SharedBuffer &&other) noexcept;
+#endif
+
+        /**
+         *  Drops our reference.
+         */
+        ~SharedBuffer();
+
+        /**
+         *  Add a reference and return it as a token, suitable for 
+         *  sending through a Queue of sizeof(void *) items. The 
+         *  receiver must Adopt() it, or the buffer is never freed.
+         *
+         *  @return The token.
+         */
+        void *Share();
+
+        /**
+         *  Give up our reference as a token, without touching the
+         *  count. The handle is empty afterwards.
+         *
+         *  @return The token.
+         */
+        void *Detach();
+
+        /**
+         *  Drop our reference now, leaving the handle empty. If this
+         *  is the last reference, the buffer goes back to its pool.
+         */
+        void Release();
+
+        /**
+         *  Release() in ISR context.
+         *
+         *  @param pxHigherPriorityTaskWoken Set to pdTRUE if freeing
+         *  the buffer unblocked a higher priority task.
+         */
+        void ReleaseFromISR(BaseType_t *pxHigherPriorityTaskWoken = NULL);
+
+        /**
+         *  @return true if the handle refers to a buffer.
+         */
+        inline bool IsValid() const
+        {
+            return Buffer != NULL;
+        }
+
+        /**
+         *  @return The data area of the buffer, or NULL if empty.
+         */
+        void *GetData() const;
+
+        /**
+         *  @return How many bytes of data the buffer holds, or 0 if 
+         *  empty.
+         */
+        int GetSize() const;
+
+        /**
+         *  @return How many references the buffer has right now, or
+         *  0 if empty. Only useful as a hint if other tasks hold 
+         *  references.
+         */
+        int GetRefCount() const;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  The bookkeeping at the front of each pool item.
+         */
+        struct Header {
+
+            /**
+             *  The pool to give the item back to.
+             */
+            MemoryPool *Pool;
+
+            /**
+             *  How many references there are.
+             */
+            int RefCount;
+        };
+
+        /**
+         *  The buffer we refer to, or NULL.
+         */
+        Header *Buffer;
+
+        /**
+         *  Wrap a freshly allocated pool item.
+         */
+        static SharedBuffer Init(MemoryPool &pool, void *item);
+
+        /**
+         *  Take over a reference without touching the count.
+         */
+        explicit SharedBuffer(Header *buffer);
+
+        /**
+         *  Add a reference.
+         */
+        void AddRef();
+
+        /**
+         *  Drop a reference, returns true if it was the last one.
+         */
+        bool DropRef();
+};
+
+
+}
+
+#endif
@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef SIZE_CLASS_ALLOCATOR_HPP_
+#define SIZE_CLASS_ALLOCATOR_HPP_
+
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "mem_pool.hpp"
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  A general purpose allocator built out of MemoryPools, one per 
+ *  power of 2 size class from 16 to 256 bytes.
+ *
+ *  Allocate() maps a size to its class in O(1). If that class is
+ *  exhausted the next larger class is tried, and anything too large
+ *  for any class comes from the system heap. All of the class memory
+ *  is one contiguous block, so Free() can tell pool memory from heap 
+ *  memory by address alone, with no per allocation header.
+ *
+ *  Every item is aligned to SizeClassAlignment bytes.
+ *
+ *  If you define CPP_FREERTOS_SIZE_CLASS_OPERATOR_NEW in your makefile
+ *  or project, the global operator new and delete are replaced. They
+ *  use whichever SizeClassAllocator was passed to Install(), and the 
+ *  system heap before that.
+ *
+ *  Like MemoryPools, this is thread safe, but cannot be used in ISR 
+ *  context.
+ */
+class SizeClassAllocator {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  How many size classes there are.
+         */
+        static const int NumSizeClasses = 5;
+
+        /**
+         *  Item size of the smallest class. Each class after it
+         *  doubles in size.
+         */
+        static const int MinClassSize = 16;
+
+        /**
+         *  Item size of the largest class.
+         */
+        static const int MaxClassSize = MinClassSize << (NumSizeClasses - 1);
+
+        /**
+         *  Alignment of every item handed out by the pools.
+         */
+        static const int SizeClassAlignment = 16;
+
+        /**
+         *  Constructor to create a SizeClassAllocator.
+         *
+         *  This constructor uses the system malloc to obtain a single
+         *  block of memory for all of the classes.
+         *
+         *  @param itemCounts How many items to put in each class,
+         *      smallest class first.
+         *  @throws MemoryPoolMallocException on failure.
+         */
+        explicit SizeClassAllocator(const int itemCounts[NumSizeClasses]);
+
+        /**
+         *  Allocate memory.
+         *
+         *  @param size How many bytes you need.
+         *  @return Pointer to the memory, or NULL if both the pools
+         *      and the system heap are out of memory.
+         */
+        void *Allocate(size_t size);
+
+        /**
+         *  Free memory obtained from Allocate().
+         *
+         *  @param item The memory to free, may be NULL.
+         */
+        void Free(void *item);
+
+        /**
+         *  Route the global operator new and delete through an allocator.
+         *  Only has an effect if CPP_FREERTOS_SIZE_CLASS_OPERATOR_NEW
+         *  is defined.
+         *
+         *  @param allocator The allocator to use. Memory allocated
+         *      before this call is still freed correctly.
+         */
+        static void Install(SizeClassAllocator *allocator);
+
+        /**
+         *  @return The installed allocator, or NULL.
+         */
+        static inline SizeClassAllocator *Installed()
+        {
+            return GlobalAllocator;
+        }
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  One pool per size class.
+         */
+        MemoryPool *Pools[NumSizeClasses];
+
+        /**
+         *  Where each class's items start. The extra entry is the
+         *  end of the last class.
+         */
+        unsigned char *ClassStart[NumSizeClasses + 1];
+
+        /**
+         *  The allocator operator new and delete use.
+         */
+        static SizeClassAllocator *GlobalAllocator;
+
+        /**
+         *  Map a size to the smallest class that can hold it.
+         *
+         *  @return The class, or NumSizeClasses if it's too big.
+         */
+        static inline int SizeToClass(size_t size)
+        {
+            if (size <= (size_t)MinClassSize) {
+                return 0;
+            }
+            else if (size > (size_t)MaxClassSize) {
+                return NumSizeClasses;
+            }
+            else {
+                //
+                //  Number of bits needed to hold size - 1, less the
+                //  bits for MinClassSize - 1.
+                //
+                return (int)(sizeof(unsigned int) * 8) 
+                        - __builtin_clz((unsigned int)(size - 1)) 
+                        - 4;
+            }
+        }
+
+//
+//  If we are using C++11 or later, take advantage of the
+//  newer features to find bugs.
+//
+#if __cplusplus >= 201103L
+        /**
+         *  Just like the underlying MemoryPools, no destructor.
+         */
+        ~SizeClassAllocator() = delete;
+#else
+        /**
+         *  Just like the underlying MemoryPools, make the destructor 
+         *  private so it can't be accessed.
+         */
+        ~SizeClassAllocator();
+#endif
+};
+
+
+}
+
+#endif
+
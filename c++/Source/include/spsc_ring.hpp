@@ -0,0 +1,353 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef SPSC_RING_HPP_
+#define SPSC_RING_HPP_
+
+#if __cplusplus < 201103L
+#error "SpscRing requires C++11 or later"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+/**
+ *  The cache line size to keep the producer's and consumer's data
+ *  apart. Most Cortex-M parts have no data cache at all, so this only
+ *  matters on larger targets, and on the Linux port.
+ */
+#ifndef CPP_FREERTOS_CACHE_LINE_SIZE
+#define CPP_FREERTOS_CACHE_LINE_SIZE    64
+#endif
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  A lock free, single producer, single consumer ring of items.
+ *
+ *  This is meant for streaming from one ISR or task to one task. 
+ *  There are no critical sections, and no kernel calls at all while 
+ *  the consumer is keeping up: Pop() is a copy and an atomic store. 
+ *  So is Push() with NotifyConsumer false, with NotifyConsumer true 
+ *  it also runs a full fence and loads the sleeping consumer's handle.
+ *  The producer and consumer indexes sit on their own cache lines, 
+ *  and each side keeps a private copy of the other's index so it 
+ *  only reads the shared one when it looks full or empty.
+ *
+ *  The producer never blocks, Push() fails if the ring is full. The 
+ *  consumer can poll with Pop(), or block with Pop(item, Timeout), in 
+ *  which case the producer wakes it with a direct to task notification.
+ *  That uses the consumer task's notification value, so the consumer 
+ *  must not be waiting on notifications for anything else. If nothing
+ *  ever blocks, set NotifyConsumer to false and the producer skips the
+ *  check for a sleeping consumer entirely.
+ *
+ *  @tparam T The type of item.
+ *  @tparam N How many items the ring holds, a power of 2.
+ *  @tparam NotifyConsumer Whether the consumer may block.
+ */
+template<typename T, size_t N, bool NotifyConsumer = true>
+class SpscRing {
+
+    static_assert(N >= 2 && (N & (N - 1)) == 0, 
+                  "SpscRing size must be a power of 2");
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  Create an empty ring. This does not allocate anything, so 
+         *  it can be done before the scheduler starts.
+         */
+        SpscRing()
+            : Head(0),
+              TailCache(0),
+              Tail(0),
+              HeadCache(0),
+              Sleeper(NULL)
+        {
+        }
+
+        /**
+         *  Add an item. Producer only, from task context.
+         *
+         *  @param item The item you are adding.
+         *  @return true if the item was added, false if the ring is full.
+         */
+        inline bool Push(const T &item)
+        {
+            if (!Store(item)) {
+                return false;
+            }
+
+            if (NotifyConsumer) {
+                TaskHandle_t sleeper = ClaimSleeper();
+                if (sleeper != NULL) {
+                    xTaskNotifyGive(sleeper);
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         *  Add an item. Producer only, from ISR context.
+         *
+         *  @param item The item you are adding.
+         *  @param pxHigherPriorityTaskWoken Set to pdTRUE if this woke 
+         *  a higher priority consumer, may be NULL.
+         *  @return true if the item was added, false if the ring is full.
+         */
+        inline bool PushFromISR(const T &item, BaseType_t *pxHigherPriorityTaskWoken = NULL)
+        {
+            if (!Store(item)) {
+                return false;
+            }
+
+            if (NotifyConsumer) {
+                TaskHandle_t sleeper = ClaimSleeper();
+                if (sleeper != NULL) {
+                    vTaskNotifyGiveFromISR(sleeper, pxHigherPriorityTaskWoken);
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         *  Remove an item without waiting. Consumer only, from task or 
+         *  ISR context.
+         *
+         *  @param item Where the item will be returned to.
+         *  @return true if an item was removed, false if the ring is empty.
+         */
+        inline bool Pop(T &item)
+        {
+            size_t tail = Tail;
+
+            if (tail == HeadCache) {
+                HeadCache = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+                if (tail == HeadCache) {
+                    return false;
+                }
+            }
+
+            item = std::move(Items[tail & Mask]);
+            __atomic_store_n(&Tail, tail + 1, __ATOMIC_RELEASE);
+
+            return true;
+        }
+
+        /**
+         *  Remove an item, waiting for one if the ring is empty. 
+         *  Consumer only, from task context.
+         *
+         *  @param item Where the item will be returned to.
+         *  @param Timeout How long to wait.
+         *  @return true if an item was removed, false on timeout.
+         */
+        bool Pop(T &item, TickType_t Timeout)
+        {
+            static_assert(NotifyConsumer, 
+                          "Blocking Pop needs NotifyConsumer to be true");
+
+            TimeOut_t timeOut;
+            vTaskSetTimeOutState(&timeOut);
+
+            while (true) {
+
+                if (Pop(item)) {
+                    return true;
+                }
+
+                if (Timeout == 0) {
+                    return false;
+                }
+
+                //
+                //  Tell the producer we're going to sleep, then look 
+                //  again in case it pushed before it could see that.
+                //
+                __atomic_store_n(&Sleeper, xTaskGetCurrentTaskHandle(), __ATOMIC_RELAXED);
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+                bool found = Pop(item);
+
+                if (!found) {
+                    ulTaskNotifyTake(pdTRUE, Timeout);
+                }
+
+                //
+                //  If the producer already claimed us, its notification
+                //  may still arrive later. That only costs one early 
+                //  wake up next time, which the loop absorbs.
+                //
+                __atomic_store_n(&Sleeper, (TaskHandle_t)NULL, __ATOMIC_RELAXED);
+
+                if (found) {
+                    return true;
+                }
+
+                if (xTaskCheckForTimeOut(&timeOut, &Timeout) != pdFALSE) {
+                    Timeout = 0;
+                }
+            }
+        }
+
+        /**
+         *  @return How many items are in the ring. Only exact when
+         *  called by the producer or consumer.
+         */
+        inline size_t NumItems() const
+        {
+            size_t tail = __atomic_load_n(&Tail, __ATOMIC_ACQUIRE);
+            size_t head = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+            size_t n = head - tail;
+
+            //
+            //  Tail first, so Head can't look older than Tail. The two
+            //  loads still aren't atomic together, and a third task can
+            //  see Tail from before a run of Pop()s and Head from after 
+            //  as many more Push()es, so clamp.
+            //
+            if ((intptr_t)n < 0) {
+                n = 0;
+            }
+            else if (n > N) {
+                n = N;
+            }
+
+            return n;
+        }
+
+        inline bool IsEmpty() const
+        {
+            return NumItems() == 0;
+        }
+
+        inline bool IsFull() const
+        {
+            return NumItems() == N;
+        }
+
+        SpscRing(const SpscRing &) = delete;
+        SpscRing &operator=(const SpscRing &) = delete;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        static const size_t Mask = N - 1;
+
+        /**
+         *  The producer's line. Indexes run freely and are masked on 
+         *  use, so full and empty never look alike.
+         */
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) size_t Head;
+        size_t TailCache;
+
+        /**
+         *  The consumer's line.
+         */
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) size_t Tail;
+        size_t HeadCache;
+
+        /**
+         *  The consumer, while it is about to block. The producer 
+         *  reads this on every Push(), so it gets its own line rather 
+         *  than sharing one with Tail, which every Pop() writes.
+         */
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) TaskHandle_t Sleeper;
+
+        alignas(CPP_FREERTOS_CACHE_LINE_SIZE) T Items[N];
+
+        inline bool Store(const T &item)
+        {
+            size_t head = Head;
+
+            if (head - TailCache == N) {
+                TailCache = __atomic_load_n(&Tail, __ATOMIC_ACQUIRE);
+                if (head - TailCache == N) {
+                    return false;
+                }
+            }
+
+            Items[head & Mask] = item;
+            __atomic_store_n(&Head, head + 1, __ATOMIC_RELEASE);
+
+            return true;
+        }
+
+        /**
+         *  @return The consumer if it is asleep and needs waking, 
+         *  making sure only one push wakes it.
+         */
+        inline TaskHandle_t ClaimSleeper()
+        {
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+            if (__atomic_load_n(&Sleeper, __ATOMIC_RELAXED) == NULL) {
+                return NULL;
+            }
+
+            return __atomic_exchange_n(&Sleeper, (TaskHandle_t)NULL, __ATOMIC_ACQ_REL);
+        }
+};
+
+
+}
+
+#endif
@@ -0,0 +1,256 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef STATIC_MEM_POOL_HPP_
+#define STATIC_MEM_POOL_HPP_
+
+#if __cplusplus < 201103L
+#error "StaticMemoryPool requires C++11 or later"
+#endif
+
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  A Memory Pool of N objects of type T, whose geometry is fully
+ *  resolved at compile time.
+ *
+ *  The storage is an aligned array inside the object itself, so a 
+ *  StaticMemoryPool declared at file scope, or as a static, lives in 
+ *  .bss and never touches the heap. Construction is O(1): items are
+ *  handed out from the untouched part of the array first, and only
+ *  items that have been freed are linked into the free list.
+ *
+ *  Allocate() and Free() are a handful of instructions, so they are
+ *  protected by a short critical section rather than a Mutex. This
+ *  means they can also be called before the scheduler starts.
+ *
+ *  @tparam T The type of object the pool holds.
+ *  @tparam N How many objects the pool holds.
+ *  @tparam Align Power of 2 alignment of each object. Defaults to
+ *      alignof(T), and is never less than alignof(void *).
+ */
+template<typename T, size_t N, size_t Align = alignof(T)>
+class StaticMemoryPool {
+
+    static_assert(N > 0, "StaticMemoryPool must hold at least one item");
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0,
+                  "StaticMemoryPool alignment must be a power of 2");
+    static_assert(Align >= alignof(T),
+                  "StaticMemoryPool alignment is less than alignof(T)");
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  The true alignment of an item.
+         */
+        static constexpr size_t Alignment = 
+            Align < alignof(void *) ? alignof(void *) : Align;
+
+        /**
+         *  The true size of an item, rounded up to the Alignment and
+         *  large enough to hold the free list link.
+         */
+        static constexpr size_t ItemSize = 
+            (((sizeof(T) < sizeof(void *) ? sizeof(void *) : sizeof(T))
+                + Alignment - 1) / Alignment) * Alignment;
+
+        /**
+         *  How many items the pool holds.
+         */
+        static constexpr size_t Capacity = N;
+
+        /**
+         *  Constructor to create a StaticMemoryPool.
+         */
+        StaticMemoryPool()
+            : FreeItems(nullptr),
+              NextUnused(0)
+        {
+        }
+
+        /**
+         *  Allocate raw memory for one T from the pool.
+         *
+         *  @return Pointer of the memory or nullptr if the pool is empty.
+         */
+        void *Allocate()
+        {
+            void *item = nullptr;
+
+            taskENTER_CRITICAL();
+
+            if (FreeItems != nullptr) {
+                item = FreeItems;
+                FreeItems = FreeItems->Next;
+            }
+            else if (NextUnused < N) {
+                item = &Storage[NextUnused * ItemSize];
+                NextUnused++;
+            }
+
+            taskEXIT_CRITICAL();
+
+            return item;
+        }
+
+        /**
+         *  Returns raw memory back to the pool.
+         *
+         *  @note There is no checking that the item is actually
+         *  valid to be returned to this pool.
+         */
+        void Free(void *item)
+        {
+            FreeItem *freeItem = static_cast<FreeItem *>(item);
+
+            taskENTER_CRITICAL();
+
+            freeItem->Next = FreeItems;
+            FreeItems = freeItem;
+
+            taskEXIT_CRITICAL();
+        }
+
+        /**
+         *  Allocate and construct a T in place.
+         *
+         *  @param args Arguments forwarded to T's constructor.
+         *  @return The new object, or nullptr if the pool is empty.
+         */
+        template<typename... Args>
+        T *Construct(Args&&... args)
+        {
+            void *item = Allocate();
+
+            if (item == nullptr) {
+                return nullptr;
+            }
+
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+            try {
+                return new (item) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                Free(item);
+                throw;
+            }
+#else
+            return new (item) T(std::forward<Args>(args)...);
+#endif
+        }
+
+        /**
+         *  Destruct a T obtained from Construct() and return its
+         *  memory to the pool.
+         *
+         *  @param item The object, may be nullptr.
+         */
+        void Destroy(T *item)
+        {
+            if (item == nullptr) {
+                return;
+            }
+
+            item->~T();
+            Free(item);
+        }
+
+        /**
+         *  No copying or moving, handed out items point into us.
+         */
+        StaticMemoryPool(const StaticMemoryPool &) = delete;
+        StaticMemoryPool &operator=(const StaticMemoryPool &) = delete;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  A free item. While an item sits in the free list, its first
+         *  bytes hold the link to the next free item.
+         */
+        struct FreeItem {
+
+            /**
+             *  The next free item, or nullptr at the end of the list.
+             */
+            FreeItem *Next;
+        };
+
+        /**
+         *  Items that have been freed.
+         */
+        FreeItem *FreeItems;
+
+        /**
+         *  Index of the first item that has never been handed out.
+         */
+        size_t NextUnused;
+
+        /**
+         *  The items themselves.
+         */
+        alignas(Alignment) unsigned char Storage[ItemSize * N];
+};
+
+
+}
+
+#endif
+
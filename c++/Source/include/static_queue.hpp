@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef STATIC_QUEUE_HPP_
+#define STATIC_QUEUE_HPP_
+
+#include "typed_queue.hpp"
+
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+namespace cpp_freertos {
+
+
+/**
+ *  The memory behind a StaticQueue. This is a separate base class so
+ *  it exists before the TypedQueue base hands it to the kernel.
+ */
+template<typename T, UBaseType_t N>
+class StaticQueueStorage {
+
+    protected:
+
+        /**
+         *  The queue's own data structure.
+         */
+        StaticQueue_t QueueBuffer;
+
+        /**
+         *  The items.
+         */
+        uint8_t Storage[N * sizeof(T)];
+};
+
+
+/**
+ *  A TypedQueue that carries its own memory.
+ *
+ *  Constructing one never touches the FreeRTOS heap, so a global 
+ *  StaticQueue lives in .bss, can't fail for lack of memory, and can 
+ *  be placed in a particular memory region with the usual linker 
+ *  section attributes. If you need the items somewhere else, use the
+ *  TypedQueue constructor that takes the buffers directly.
+ *
+ *  Requires configSUPPORT_STATIC_ALLOCATION.
+ *
+ *  @tparam T The type of item the queue holds.
+ *  @tparam N Maximum number of items the queue can hold.
+ */
+template<typename T, UBaseType_t N>
+class StaticQueue : private StaticQueueStorage<T, N>, 
+                    public TypedQueue<T> {
+
+    static_assert(N > 0, "StaticQueue must hold at least one item");
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+        /**
+         *  Our constructor.
+         *
+         *  @throws QueueCreateException
+         */
+        StaticQueue()
+            : TypedQueue<T>(N, this->Storage, &this->QueueBuffer)
+        {
+        }
+};
+
+
+}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+#endif
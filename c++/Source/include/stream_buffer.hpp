@@ -0,0 +1,442 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef STREAM_BUFFER_HPP_
+#define STREAM_BUFFER_HPP_
+
+/**
+ *  C++ exceptions are used by default when constructors fail.
+ *  If you do not want this behavior, define the following in your makefile
+ *  or project. Note that in most / all cases when a constructor fails,
+ *  it's a fatal error. In the cases when you've defined this, the new
+ *  default behavior will be to issue a configASSERT() instead.
+ */
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+#include <exception>
+#include <string>
+#include <cstdio>
+#ifdef CPP_FREERTOS_NO_CPP_STRINGS
+#error "FreeRTOS-Addons require C++ Strings if you are using exceptions"
+#endif
+#endif
+#include "FreeRTOS.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+
+namespace cpp_freertos {
+
+
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+/**
+ *  This is the exception that is thrown if a StreamBuffer or 
+ *  MessageBuffer constructor fails.
+ */
+class StreamBufferCreateException : public std::exception {
+
+    public:
+        /**
+         *  Create the exception.
+         */
+        StreamBufferCreateException()
+        {
+            sprintf(errorString, "Stream Buffer Constructor Failed");
+        }
+
+        /**
+         *  Create the exception.
+         */
+        explicit StreamBufferCreateException(const char *info)
+        {
+            snprintf(errorString, sizeof(errorString),
+                        "Stream Buffer Constructor Failed %s", info);
+        }
+
+        /**
+         *  Get what happened as a string.
+         *  We are overriding the base implementation here.
+         */
+        virtual const char *what() const throw()
+        {
+            return errorString;
+        }
+
+    private:
+        /**
+         *  A text string representing what failed.
+         */
+        char errorString[80];
+};
+#endif
+
+
+/**
+ *  Wrapper for FreeRTOS stream buffers.
+ *
+ *  A stream buffer moves a stream of bytes from exactly one writer to 
+ *  exactly one reader, a task or an ISR on each side. There are no 
+ *  item boundaries, so a UART driver can push whatever bytes it has 
+ *  and the reader can take as many as it wants at once, with one copy 
+ *  per call instead of one per item like a Queue of bytes. If more than 
+ *  one task writes, or more than one reads, the callers on that side 
+ *  have to serialize themselves, for example with a Mutex.
+ *
+ *  Stream buffers are built on task notifications, so they need 
+ *  stream_buffer.c from FreeRTOS V10.0.0 or later in the build.
+ */
+class StreamBuffer {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+        /**
+         *  Our constructor.
+         *
+         *  @throws StreamBufferCreateException
+         *  @param bufferSize The most bytes the buffer can hold.
+         *  @param triggerLevel How many bytes have to be in the buffer 
+         *         before a blocked reader is woken.
+         */
+        explicit StreamBuffer(size_t bufferSize, size_t triggerLevel = 1);
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        /**
+         *  Our constructor, using memory you pass in. This constructor
+         *  does not touch the FreeRTOS heap.
+         *
+         *  @throws StreamBufferCreateException
+         *  @param bufferSize The most bytes the buffer can hold.
+         *  @param triggerLevel How many bytes have to be in the buffer 
+         *         before a blocked reader is woken.
+         *  @param storage At least bufferSize + 1 bytes to hold the data.
+         *  @param streamBuffer Holds the stream buffer's own data structure.
+         */
+        StreamBuffer(   size_t bufferSize, 
+                        size_t triggerLevel,
+                        uint8_t *storage, 
+                        StaticStreamBuffer_t *streamBuffer);
+#endif
+
+        /**
+         *  Our destructor.
+         */
+        ~StreamBuffer();
+
+        /**
+         *  Write bytes to the buffer. 
+         *
+         *  @param data The bytes to write.
+         *  @param length How many bytes to write.
+         *  @param Timeout How long to wait for enough space for all of 
+         *         them if the buffer is too full.
+         *  @return How many bytes were written, which is less than 
+         *          length if the timeout expired first.
+         */
+        size_t Send(const void *data, size_t length, TickType_t Timeout = portMAX_DELAY);
+
+        /**
+         *  Write bytes to the buffer in ISR context. This writes as many
+         *  as fit.
+         *
+         *  @param data The bytes to write.
+         *  @param length How many bytes to write.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return How many bytes were written.
+         */
+        size_t SendFromISR( const void *data, 
+                            size_t length, 
+                            BaseType_t *pxHigherPriorityTaskWoken);
+
+        /**
+         *  Read bytes from the buffer.
+         *
+         *  @param data Where the bytes will be returned to.
+         *  @param maxLength The most bytes to read.
+         *  @param Timeout How long to wait for the trigger level to be 
+         *         reached if the buffer holds fewer bytes than that.
+         *  @return How many bytes were read, 0 on timeout. This can be
+         *          less than the trigger level if the timeout expired
+         *          with some bytes in the buffer.
+         */
+        size_t Receive(void *data, size_t maxLength, TickType_t Timeout = portMAX_DELAY);
+
+        /**
+         *  Read whatever bytes are in the buffer in ISR context.
+         *
+         *  @param data Where the bytes will be returned to.
+         *  @param maxLength The most bytes to read.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return How many bytes were read.
+         */
+        size_t ReceiveFromISR(  void *data, 
+                                size_t maxLength, 
+                                BaseType_t *pxHigherPriorityTaskWoken);
+
+        /**
+         *  Change how many bytes have to be in the buffer before a 
+         *  blocked reader is woken. Small values give low latency, large
+         *  ones fewer wake ups per byte.
+         *
+         *  @param triggerLevel The new trigger level.
+         *  @return true if it was set, false if it is bigger than the 
+         *          buffer.
+         */
+        bool SetTriggerLevel(size_t triggerLevel);
+
+        /**
+         *  Is the buffer empty?
+         *  @return true if the buffer was empty when this was called.
+         */
+        bool IsEmpty();
+
+        /**
+         *  Is the buffer full?
+         *  @return true if the buffer was full when this was called.
+         */
+        bool IsFull();
+
+        /**
+         *  Throw away everything in the buffer. This only works if no 
+         *  task is blocked sending or receiving.
+         *
+         *  @return true if the buffer was reset.
+         */
+        bool Reset();
+
+        /**
+         *  How many bytes are currently in the buffer.
+         *  @return the number of bytes that can be read.
+         */
+        size_t BytesAvailable();
+
+        /**
+         *  How many more bytes fit in the buffer.
+         *  @return the number of bytes that can be written.
+         */
+        size_t SpacesAvailable();
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Protected API
+    //  Not intended for use by application code.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    protected:
+        /**
+         *  FreeRTOS stream buffer handle.
+         */
+        StreamBufferHandle_t handle;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+        /**
+         *  You can't copy a stream buffer.
+         */
+        StreamBuffer(const StreamBuffer &);
+        StreamBuffer &operator=(const StreamBuffer &);
+};
+
+
+/**
+ *  Wrapper for FreeRTOS message buffers.
+ *
+ *  A message buffer is a stream buffer that keeps message boundaries. 
+ *  Each Send() writes one variable length message, and each Receive() 
+ *  reads exactly one whole message, so it suits packets of different 
+ *  sizes better than a Queue sized for the biggest one. It has the 
+ *  same one writer, one reader rule as StreamBuffer, and each message 
+ *  costs an extra sizeof(size_t) bytes of buffer space for its length.
+ */
+class MessageBuffer {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+        /**
+         *  Our constructor.
+         *
+         *  @throws StreamBufferCreateException
+         *  @param bufferSize The most bytes the buffer can hold, 
+         *         including the length of each message.
+         */
+        explicit MessageBuffer(size_t bufferSize);
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        /**
+         *  Our constructor, using memory you pass in. This constructor
+         *  does not touch the FreeRTOS heap.
+         *
+         *  @throws StreamBufferCreateException
+         *  @param bufferSize The most bytes the buffer can hold, 
+         *         including the length of each message.
+         *  @param storage At least bufferSize + 1 bytes to hold the data.
+         *  @param messageBuffer Holds the message buffer's own data 
+         *         structure.
+         */
+        MessageBuffer(  size_t bufferSize, 
+                        uint8_t *storage, 
+                        StaticMessageBuffer_t *messageBuffer);
+#endif
+
+        /**
+         *  Our destructor.
+         */
+        ~MessageBuffer();
+
+        /**
+         *  Write one message.
+         *
+         *  @param message The message to write.
+         *  @param length How long the message is.
+         *  @param Timeout How long to wait for room for the whole 
+         *         message if the buffer is too full.
+         *  @return true if the message was written, false if it was not.
+         */
+        bool Send(const void *message, size_t length, TickType_t Timeout = portMAX_DELAY);
+
+        /**
+         *  Write one message in ISR context.
+         *
+         *  @param message The message to write.
+         *  @param length How long the message is.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if the message was written, false if it did not fit.
+         */
+        bool SendFromISR(   const void *message, 
+                            size_t length, 
+                            BaseType_t *pxHigherPriorityTaskWoken);
+
+        /**
+         *  Read one message.
+         *
+         *  @param message Where the message will be returned to.
+         *  @param maxLength How big the message buffer you passed is. If 
+         *         the next message is longer, it is left where it is.
+         *  @param Timeout How long to wait for a message if there are none.
+         *  @return The length of the message read, 0 if none was read.
+         */
+        size_t Receive(void *message, size_t maxLength, TickType_t Timeout = portMAX_DELAY);
+
+        /**
+         *  Read one message in ISR context.
+         *
+         *  @param message Where the message will be returned to.
+         *  @param maxLength How big the message buffer you passed is.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return The length of the message read, 0 if none was read.
+         */
+        size_t ReceiveFromISR(  void *message, 
+                                size_t maxLength, 
+                                BaseType_t *pxHigherPriorityTaskWoken);
+
+        /**
+         *  Is the buffer empty?
+         *  @return true if there were no messages when this was called.
+         */
+        bool IsEmpty();
+
+        /**
+         *  Is the buffer full?
+         *  @return true if not even an empty message would fit when 
+         *          this was called.
+         */
+        bool IsFull();
+
+        /**
+         *  Throw away every message in the buffer. This only works if 
+         *  no task is blocked sending or receiving.
+         *
+         *  @return true if the buffer was reset.
+         */
+        bool Reset();
+
+        /**
+         *  How many bytes are free, before taking off the length that 
+         *  the next message would need.
+         *  @return the number of free bytes.
+         */
+        size_t SpacesAvailable();
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Protected API
+    //  Not intended for use by application code.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    protected:
+        /**
+         *  FreeRTOS message buffer handle.
+         */
+        MessageBufferHandle_t handle;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+        /**
+         *  You can't copy a message buffer.
+         */
+        MessageBuffer(const MessageBuffer &);
+        MessageBuffer &operator=(const MessageBuffer &);
+};
+
+
+}
+#endif
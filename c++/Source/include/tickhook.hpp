@@ -46,6 +46,9 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include <list>
+#ifdef CPP_FREERTOS_POOL_ALLOCATOR
+#include "pool_allocator.hpp"
+#endif
 
 #if ( configUSE_TICK_HOOK == 1 )
 
@@ -133,11 +136,26 @@ class TickHook {
     //
     /////////////////////////////////////////////////////////////////////////
     private:
+        /**
+         *  The type of the callback list.
+         */
+#ifdef CPP_FREERTOS_POOL_ALLOCATOR
+        typedef std::list<TickHook *, PoolAllocator<TickHook *> > CallbackList;
+#else
+        typedef std::list<TickHook *> CallbackList;
+#endif
+
         /**
          *  List of Tick Hook callbacks that are executed in the 
          *  Tick ISR.
          */
-        static std::list<TickHook *>Callbacks;
+        static CallbackList Callbacks;
+
+        /**
+         *  Move our nodes from Callbacks to removed, without freeing
+         *  anything. Must be called inside a critical section.
+         */
+        void Unlink(CallbackList &removed);
 
         /**
          *  Should the tick hook run?
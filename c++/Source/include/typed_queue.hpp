@@ -0,0 +1,454 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef TYPED_QUEUE_HPP_
+#define TYPED_QUEUE_HPP_
+
+#if __cplusplus < 201103L
+#error "TypedQueue requires C++11 or later"
+#endif
+
+#include <type_traits>
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+#include "queue.hpp"
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  Typed wrapper for FreeRTOS queues.
+ *
+ *  This is the compile time counterpart of Queue. The item size comes
+ *  from T, items are passed by reference instead of as void pointers,
+ *  and nothing is virtual, so every call inlines down to the kernel 
+ *  call. FreeRTOS copies items with memcpy, so T has to be trivially 
+ *  copyable. That also means moving an item is the same as copying it,
+ *  and temporaries can be passed to Enqueue() directly.
+ *
+ *  @tparam T The type of item the queue holds.
+ */
+template<typename T>
+class TypedQueue {
+
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "TypedQueue items are copied with memcpy, T must be trivially copyable");
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+        /**
+         *  Our constructor.
+         *
+         *  @throws QueueCreateException
+         *  @param maxItems Maximum number of items this queue can hold.
+         */
+        explicit TypedQueue(UBaseType_t maxItems)
+            : handle(xQueueCreate(maxItems, sizeof(T)))
+        {
+            if (handle == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+                throw QueueCreateException();
+#else
+                configASSERT(!"Queue Constructor Failed");
+#endif
+            }
+        }
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        /**
+         *  Our constructor, using memory you pass in. This constructor
+         *  does not touch the FreeRTOS heap.
+         *
+         *  @throws QueueCreateException
+         *  @param maxItems Maximum number of items this queue can hold.
+         *  @param storage At least maxItems * sizeof(T) bytes to hold 
+         *         the items.
+         *  @param queueBuffer Holds the queue's own data structure.
+         */
+        TypedQueue( UBaseType_t maxItems, 
+                    uint8_t *storage, 
+                    StaticQueue_t *queueBuffer)
+            : handle(xQueueCreateStatic(maxItems, sizeof(T), storage, queueBuffer))
+        {
+            if (handle == NULL) {
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+                throw QueueCreateException();
+#else
+                configASSERT(!"Queue Constructor Failed");
+#endif
+            }
+        }
+#endif
+
+        /**
+         *  Our destructor.
+         */
+        ~TypedQueue()
+        {
+            vQueueDelete(handle);
+        }
+
+        /**
+         *  Add an item to the back of the queue.
+         *
+         *  @param item The item you are adding.
+         *  @param Timeout How long to wait to add the item to the queue if
+         *         the queue is currently full.
+         *  @return true if the item was added, false if it was not.
+         */
+        inline bool Enqueue(const T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            return xQueueSendToBack(handle, &item, Timeout) == pdTRUE;
+        }
+
+        /**
+         *  Remove an item from the front of the queue.
+         *
+         *  @param item Where the item you are removing will be returned to.
+         *  @param Timeout How long to wait to remove an item if the queue
+         *         is currently empty.
+         *  @return true if an item was removed, false if no item was removed.
+         */
+        inline bool Dequeue(T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            return xQueueReceive(handle, &item, Timeout) == pdTRUE;
+        }
+
+        /**
+         *  Make a copy of an item from the front of the queue. This will
+         *  not remove it from the head of the queue.
+         *
+         *  @param item Where the item will be copied to.
+         *  @param Timeout How long to wait if the queue is currently empty.
+         *  @return true if an item was copied, false if no item was copied.
+         */
+        inline bool Peek(T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            return xQueuePeek(handle, &item, Timeout) == pdTRUE;
+        }
+
+        /**
+         *  Add several items to the back of the queue, in order.
+         *
+         *  @param items Array of items to add.
+         *  @param count How many items are in the array.
+         *  @param Timeout How long to wait for room, for the whole batch.
+         *  @return How many items were added, starting from the first.
+         */
+        UBaseType_t EnqueueMany(const T *items, 
+                                UBaseType_t count, 
+                                TickType_t Timeout = portMAX_DELAY)
+        {
+            TimeOut_t timeOut;
+            UBaseType_t i;
+
+            vTaskSetTimeOutState(&timeOut);
+
+            for (i = 0; i < count; i++) {
+
+                if (xQueueSendToBack(handle, &items[i], Timeout) != pdTRUE) {
+                    break;
+                }
+
+                //
+                //  The timeout covers the whole batch, not each item.
+                //
+                if (xTaskCheckForTimeOut(&timeOut, &Timeout) != pdFALSE) {
+                    Timeout = 0;
+                }
+            }
+
+            return i;
+        }
+
+        /**
+         *  Remove up to maxItems items from the front of the queue. 
+         *  This waits for the first item only, then takes whatever else 
+         *  is already there, so a burst costs a single wake up.
+         *
+         *  @param items Where the items will be returned to.
+         *  @param maxItems The most items to remove.
+         *  @param Timeout How long to wait for the first item if the 
+         *         queue is currently empty.
+         *  @return How many items were removed, 0 on timeout.
+         */
+        UBaseType_t DequeueMany(T *items, 
+                                UBaseType_t maxItems, 
+                                TickType_t Timeout = portMAX_DELAY)
+        {
+            if (maxItems == 0 || xQueueReceive(handle, &items[0], Timeout) != pdTRUE) {
+                return 0;
+            }
+
+            UBaseType_t i;
+
+            for (i = 1; i < maxItems; i++) {
+                if (xQueueReceive(handle, &items[i], 0) != pdTRUE) {
+                    break;
+                }
+            }
+
+            return i;
+        }
+
+        /**
+         *  Add an item to the back of the queue in ISR context.
+         *
+         *  @param item The item you are adding.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if the item was added, false if it was not.
+         */
+        inline bool EnqueueFromISR(const T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            return xQueueSendToBackFromISR(handle, &item, pxHigherPriorityTaskWoken) == pdTRUE;
+        }
+
+        /**
+         *  Remove an item from the front of the queue in ISR context.
+         *
+         *  @param item Where the item you are removing will be returned to.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if an item was removed, false if no item was removed.
+         */
+        inline bool DequeueFromISR(T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            return xQueueReceiveFromISR(handle, &item, pxHigherPriorityTaskWoken) == pdTRUE;
+        }
+
+        /**
+         *  Make a copy of an item from the front of the queue in ISR 
+         *  context. This will not remove it from the head of the queue.
+         *
+         *  @param item Where the item will be copied to.
+         *  @return true if an item was copied, false if no item was copied.
+         */
+        inline bool PeekFromISR(T &item)
+        {
+            return xQueuePeekFromISR(handle, &item) == pdTRUE;
+        }
+
+        /**
+         *  Is the queue empty?
+         *  @return true if the queue was empty when this was called, false if
+         *  the queue was not empty.
+         */
+        inline bool IsEmpty()
+        {
+            return uxQueueMessagesWaiting(handle) == 0;
+        }
+
+        /**
+         *  Is the queue full?
+         *  @return true if the queue was full when this was called, false if
+         *  the queue was not full.
+         */
+        inline bool IsFull()
+        {
+            return uxQueueSpacesAvailable(handle) == 0;
+        }
+
+        /**
+         *  Remove all objects from the queue.
+         */
+        inline void Flush()
+        {
+            xQueueReset(handle);
+        }
+
+        /**
+         *  How many items are currently in the queue.
+         *  @return the number of items in the queue.
+         */
+        inline UBaseType_t NumItems()
+        {
+            return uxQueueMessagesWaiting(handle);
+        }
+
+        /**
+         *  How many empty spaces are currently left in the queue.
+         *  @return the number of remaining spaces.
+         */
+        inline UBaseType_t NumSpacesLeft()
+        {
+            return uxQueueSpacesAvailable(handle);
+        }
+
+        TypedQueue(const TypedQueue &) = delete;
+        TypedQueue &operator=(const TypedQueue &) = delete;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Protected API
+    //  Not intended for use by application code.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    protected:
+        /**
+         *  FreeRTOS queue handle.
+         */
+        QueueHandle_t handle;
+
+    /**
+     *  A QueueSet adds our handle to its kernel queue set.
+     */
+    friend class QueueSet;
+};
+
+
+/**
+ *  Typed deque, the compile time counterpart of Deque. Items can also
+ *  be added to the front, so they are removed ahead of everything added
+ *  with Enqueue().
+ *
+ *  @tparam T The type of item the queue holds.
+ */
+template<typename T>
+class TypedDeque : public TypedQueue<T> {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+        /**
+         *  Our constructor.
+         *
+         *  @throws QueueCreateException
+         *  @param maxItems Maximum number of items this queue can hold.
+         */
+        explicit TypedDeque(UBaseType_t maxItems)
+            : TypedQueue<T>(maxItems)
+        {
+        }
+
+        /**
+         *  Add an item to the front of the queue.
+         *
+         *  @param item The item you are adding.
+         *  @param Timeout How long to wait to add the item to the queue if
+         *         the queue is currently full.
+         *  @return true if the item was added, false if it was not.
+         */
+        inline bool EnqueueToFront(const T &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            return xQueueSendToFront(this->handle, &item, Timeout) == pdTRUE;
+        }
+
+        /**
+         *  Add an item to the front of the queue in ISR context.
+         *
+         *  @param item The item you are adding.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true if the item was added, false if it was not.
+         */
+        inline bool EnqueueToFrontFromISR(const T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            return xQueueSendToFrontFromISR(this->handle, &item, pxHigherPriorityTaskWoken) == pdTRUE;
+        }
+};
+
+
+/**
+ *  Typed binary queue with overwrite, the compile time counterpart of 
+ *  BinaryQueue. It holds one item, and each Enqueue() replaces it.
+ *
+ *  @tparam T The type of item the queue holds.
+ */
+template<typename T>
+class TypedBinaryQueue : public TypedQueue<T> {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+        /**
+         *  Our constructor.
+         *
+         *  @throws QueueCreateException
+         */
+        TypedBinaryQueue()
+            : TypedQueue<T>(1)
+        {
+        }
+
+        /**
+         *  Replace the item in the queue.
+         *
+         *  @param item The item you are adding.
+         *  @return true always, because of overwrite.
+         */
+        inline bool Enqueue(const T &item)
+        {
+            xQueueOverwrite(this->handle, &item);
+            return true;
+        }
+
+        /**
+         *  Replace the item in the queue in ISR context.
+         *
+         *  @param item The item you are adding.
+         *  @param pxHigherPriorityTaskWoken Did this operation result in a
+         *         rescheduling event.
+         *  @return true always, because of overwrite.
+         */
+        inline bool EnqueueFromISR(const T &item, BaseType_t *pxHigherPriorityTaskWoken)
+        {
+            xQueueOverwriteFromISR(this->handle, &item, pxHigherPriorityTaskWoken);
+            return true;
+        }
+};
+
+
+}
+#endif
@@ -0,0 +1,335 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef ZERO_COPY_QUEUE_HPP_
+#define ZERO_COPY_QUEUE_HPP_
+
+#if __cplusplus < 201103L
+#error "ZeroCopyQueue requires C++11 or later"
+#endif
+
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include "FreeRTOS.h"
+#include "mem_pool.hpp"
+#include "queue.hpp"
+
+
+namespace cpp_freertos {
+
+
+/**
+ *  A typed queue that passes objects by pointer instead of by copy.
+ *
+ *  Objects are constructed in place in a MemoryPool owned by the 
+ *  queue, and only the pointer travels through the underlying 
+ *  FreeRTOS queue. Ownership is tracked with move only Item handles:
+ *  an Item that is never enqueued, or one that has been dequeued and 
+ *  goes out of scope, destroys its object and returns the memory to 
+ *  the pool automatically.
+ *
+ *  The pool and the queue hold the same number of items, so anything
+ *  that could be allocated can always be enqueued. Allocation never
+ *  blocks unless you ask it to with EmplaceWithTimeout(), which is a
+ *  natural way to apply backpressure to a producer.
+ *
+ *  Like MemoryPool, a ZeroCopyQueue cannot be deleted.
+ *
+ *  @tparam T The type of object passed through the queue.
+ */
+template<typename T>
+class ZeroCopyQueue {
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Public API
+    //
+    /////////////////////////////////////////////////////////////////////////
+    public:
+
+        /**
+         *  An owning handle to one object from a ZeroCopyQueue.
+         */
+        class Item {
+
+            public:
+
+                /**
+                 *  Create an empty handle.
+                 */
+                Item()
+                    : Owner(NULL),
+                      Object(NULL)
+                {
+                }
+
+                Item(Item &&other) noexcept
+                    : Owner(other.Owner),
+                      Object(other.Object)
+                {
+                    other.Object = NULL;
+                }
+
+                Item &operator=(Item &&other) noexcept
+                {
+                    if (this != &other) {
+                        Reset();
+                        Owner = other.Owner;
+                        Object = other.Object;
+                        other.Object = NULL;
+                    }
+                    return *this;
+                }
+
+                Item(const Item &) = delete;
+                Item &operator=(const Item &) = delete;
+
+                /**
+                 *  Destroys the object and frees its memory, if 
+                 *  we still own one.
+                 */
+                ~Item()
+                {
+                    Reset();
+                }
+
+                /**
+                 *  Destroy the object and free its memory now.
+                 */
+                void Reset()
+                {
+                    if (Object != NULL) {
+                        Object->~T();
+                        Owner->Pool->Free(Object);
+                        Object = NULL;
+                    }
+                }
+
+                /**
+                 *  @return true if the handle owns an object.
+                 */
+                explicit operator bool() const
+                {
+                    return Object != NULL;
+                }
+
+                T *Get() const
+                {
+                    return Object;
+                }
+
+                T &operator*() const
+                {
+                    return *Object;
+                }
+
+                T *operator->() const
+                {
+                    return Object;
+                }
+
+            private:
+
+                Item(ZeroCopyQueue *owner, T *object)
+                    : Owner(owner),
+                      Object(object)
+                {
+                }
+
+                /**
+                 *  The queue whose pool the object lives in.
+                 */
+                ZeroCopyQueue *Owner;
+
+                /**
+                 *  The object, or NULL.
+                 */
+                T *Object;
+
+            friend class ZeroCopyQueue;
+        };
+
+        /**
+         *  Create a ZeroCopyQueue.
+         *
+         *  @param maxItems How many objects can exist at once.
+         *  @throws MemoryPoolMallocException, QueueCreateException on 
+         *  failure.
+         */
+        explicit ZeroCopyQueue(UBaseType_t maxItems)
+            : Pool(new MemoryPool(sizeof(T), maxItems, alignof(T))),
+              Pointers(maxItems, sizeof(T *))
+        {
+        }
+
+        /**
+         *  Construct an object in pool memory.
+         *
+         *  @param args Arguments for T's constructor.
+         *  @return A handle owning the object, or an empty handle if 
+         *  every item is in use.
+         */
+        template<typename... Args>
+        Item Emplace(Args&&... args)
+        {
+            return Construct(Pool->Allocate(), std::forward<Args>(args)...);
+        }
+
+        /**
+         *  Construct an object in pool memory, waiting for an item to
+         *  be freed if they are all in use.
+         *
+         *  @param timeout How long to wait, in ticks.
+         *  @param args Arguments for T's constructor.
+         *  @return A handle owning the object, or an empty handle if 
+         *  the timeout expired.
+         */
+        template<typename... Args>
+        Item EmplaceWithTimeout(TickType_t timeout, Args&&... args)
+        {
+            return Construct(Pool->Allocate(timeout), std::forward<Args>(args)...);
+        }
+
+        /**
+         *  Send an object to the back of the queue. Only the pointer 
+         *  is copied.
+         *
+         *  @param item A handle from this queue. On success it is left
+         *  empty, on failure it still owns the object.
+         *  @param Timeout How long to wait if the queue is full.
+         *  @return true if the item was queued.
+         */
+        bool Enqueue(Item &item, TickType_t Timeout = portMAX_DELAY)
+        {
+            configASSERT(item.Owner == this);
+
+            T *object = item.Object;
+
+            if (!Pointers.Enqueue(&object, Timeout)) {
+                return false;
+            }
+
+            item.Object = NULL;
+            return true;
+        }
+
+        /**
+         *  Receive an object from the front of the queue.
+         *
+         *  @param Timeout How long to wait if the queue is empty.
+         *  @return A handle owning the object, or an empty handle on
+         *  timeout.
+         */
+        Item Dequeue(TickType_t Timeout = portMAX_DELAY)
+        {
+            T *object;
+
+            if (!Pointers.Dequeue(&object, Timeout)) {
+                return Item();
+            }
+
+            return Item(this, object);
+        }
+
+        /**
+         *  @return How many objects are waiting in the queue.
+         */
+        UBaseType_t NumItems()
+        {
+            return Pointers.NumItems();
+        }
+
+        ZeroCopyQueue(const ZeroCopyQueue &) = delete;
+        ZeroCopyQueue &operator=(const ZeroCopyQueue &) = delete;
+
+    /////////////////////////////////////////////////////////////////////////
+    //
+    //  Private API
+    //  The internals of this class.
+    //
+    /////////////////////////////////////////////////////////////////////////
+    private:
+
+        /**
+         *  Where the objects live.
+         */
+        MemoryPool *Pool;
+
+        /**
+         *  Pointers to queued objects.
+         */
+        Queue Pointers;
+
+        /**
+         *  Build an object in a freshly allocated pool item.
+         */
+        template<typename... Args>
+        Item Construct(void *memory, Args&&... args)
+        {
+            if (memory == NULL) {
+                return Item();
+            }
+
+#ifndef CPP_FREERTOS_NO_EXCEPTIONS
+            try {
+                return Item(this, new (memory) T(std::forward<Args>(args)...));
+            }
+            catch (...) {
+                Pool->Free(memory);
+                throw;
+            }
+#else
+            return Item(this, new (memory) T(std::forward<Args>(args)...));
+#endif
+        }
+
+        /**
+         *  The pool can't be deleted, so neither can we.
+         */
+        ~ZeroCopyQueue() = delete;
+};
+
+
+}
+
+#endif
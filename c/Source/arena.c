@@ -0,0 +1,261 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "arena.h"
+
+
+/**
+ *  Where an Arena's region came from.
+ */
+typedef enum ArenaSource_t_ {
+
+    ArenaFromMalloc,
+    ArenaFromCaller,
+    ArenaFromPool
+
+} ArenaSource_t;
+
+
+/**
+ *  The actual Arena data structure.
+ */
+typedef struct PvtArena_t_ {
+
+    /**
+     *  Start of the region.
+     */
+    unsigned char *Buffer;
+
+    /**
+     *  Size of the region in bytes.
+     */
+    int Size;
+
+    /**
+     *  Offset of the first free byte in the region.
+     */
+    int Offset;
+
+    /**
+     *  Where the region came from, so we can give it back.
+     */
+    ArenaSource_t Source;
+
+    /**
+     *  The pool we borrowed the region from, if any.
+     */
+    MemoryPool_t Pool;
+
+} PvtArena_t;
+
+
+static PvtArena_t *CreateArenaInternal( unsigned char *Buffer, 
+                                        int Size,
+                                        ArenaSource_t Source,
+                                        MemoryPool_t Pool)
+{
+    /*********************************/
+    PvtArena_t *Arena;
+    /*********************************/
+
+    Arena = (PvtArena_t *)malloc(sizeof(PvtArena_t));
+    if (Arena == NULL) {
+        return NULL;
+    }
+
+    Arena->Buffer = Buffer;
+    Arena->Size = Size;
+    Arena->Offset = 0;
+    Arena->Source = Source;
+    Arena->Pool = Pool;
+
+    return Arena;
+}
+
+
+Arena_t CreateArena(int Size)
+{
+    /*********************************/
+    PvtArena_t *Arena;
+    unsigned char *Buffer;
+    /*********************************/
+
+    Buffer = (unsigned char *)malloc(Size);
+    if (Buffer == NULL) {
+        return NULL;
+    }
+
+    Arena = CreateArenaInternal(Buffer, Size, ArenaFromMalloc, NULL);
+    if (Arena == NULL) {
+        free(Buffer);
+        return NULL;
+    }
+
+    return (Arena_t)Arena;
+}
+
+
+Arena_t CreateArenaStatic(void *Buffer, int Size)
+{
+    return (Arena_t)CreateArenaInternal((unsigned char *)Buffer, 
+                                        Size, 
+                                        ArenaFromCaller, 
+                                        NULL);
+}
+
+
+Arena_t CreateArenaFromPool(MemoryPool_t pool)
+{
+    /*********************************/
+    PvtArena_t *Arena;
+    unsigned char *Buffer;
+    /*********************************/
+
+    Buffer = (unsigned char *)MemoryPoolAllocate(pool);
+    if (Buffer == NULL) {
+        return NULL;
+    }
+
+    Arena = CreateArenaInternal(Buffer, 
+                                MemoryPoolGetItemSize(pool),
+                                ArenaFromPool, 
+                                pool);
+    if (Arena == NULL) {
+        MemoryPoolFree(pool, Buffer);
+        return NULL;
+    }
+
+    return (Arena_t)Arena;
+}
+
+
+void DeleteArena(Arena_t arena)
+{
+    /*********************************/
+    PvtArena_t *Arena;
+    /*********************************/
+
+    Arena = (PvtArena_t *)arena;
+
+    if (Arena->Source == ArenaFromMalloc) {
+        free(Arena->Buffer);
+    }
+    else if (Arena->Source == ArenaFromPool) {
+        MemoryPoolFree(Arena->Pool, Arena->Buffer);
+    }
+
+    free(Arena);
+}
+
+
+void *ArenaAllocate(Arena_t arena, int Size, int Alignment)
+{
+    /*********************************/
+    PvtArena_t *Arena;
+    uintptr_t Base;
+    int Padding;
+    void *Memory;
+    /*********************************/
+
+    Arena = (PvtArena_t *)arena;
+
+    configASSERT(Alignment > 0 && (Alignment & (Alignment - 1)) == 0);
+
+    Base = (uintptr_t)(Arena->Buffer + Arena->Offset);
+    Padding = (int)((Alignment - (Base & (Alignment - 1))) & (Alignment - 1));
+
+    if (Size < 0 || Padding + Size > Arena->Size - Arena->Offset) {
+        return NULL;
+    }
+
+    Memory = Arena->Buffer + Arena->Offset + Padding;
+    Arena->Offset += Padding + Size;
+
+    return Memory;
+}
+
+
+void ArenaReset(Arena_t arena)
+{
+    ((PvtArena_t *)arena)->Offset = 0;
+}
+
+
+int ArenaGetMarker(Arena_t arena)
+{
+    return ((PvtArena_t *)arena)->Offset;
+}
+
+
+void ArenaResetToMarker(Arena_t arena, int Marker)
+{
+    /*********************************/
+    PvtArena_t *Arena;
+    /*********************************/
+
+    Arena = (PvtArena_t *)arena;
+
+    configASSERT(Marker >= 0 && Marker <= Arena->Offset);
+
+    Arena->Offset = Marker;
+}
+
+
+int ArenaGetBytesUsed(Arena_t arena)
+{
+    return ((PvtArena_t *)arena)->Offset;
+}
+
+
+int ArenaGetBytesFree(Arena_t arena)
+{
+    /*********************************/
+    PvtArena_t *Arena;
+    /*********************************/
+
+    Arena = (PvtArena_t *)arena;
+
+    return Arena->Size - Arena->Offset;
+}
@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+
+#include "FreeRTOS.h"
+#include "mem_pool.h"
+
+
+/**
+ *  Handle for arenas.
+ *
+ *  An arena hands out memory of any size and alignment from a single
+ *  region by bumping an offset, and takes it all back at once with
+ *  ArenaReset(). There is no per allocation free.
+ *
+ *  Arenas are not thread safe, the usual pattern is one per task.
+ */
+typedef void * Arena_t;
+
+
+/**
+ *  The alignment to ask for if any fundamental type may be stored.
+ */
+#define ARENA_DEFAULT_ALIGNMENT     (2 * sizeof(void *))
+
+
+/**
+ *  Create an Arena, using malloc for the region.
+ *
+ *  @param Size How many bytes the Arena holds.
+ *  @return A Handle to the Arena, or NULL on failure.
+ */
+Arena_t CreateArena(int Size);
+
+
+/**
+ *  Create an Arena using memory you pass in for the region.
+ *
+ *  @param Buffer Pointer to the preallocated memory.
+ *  @param Size How big is the buffer you are passing in.
+ *  @return A Handle to the Arena, or NULL on failure.
+ */
+Arena_t CreateArenaStatic(void *Buffer, int Size);
+
+
+/**
+ *  Create an Arena that borrows one buffer from a MemoryPool for 
+ *  its region. The buffer is returned when the Arena is deleted.
+ *
+ *  @param pool The pool to take the region from.
+ *  @return A Handle to the Arena, or NULL if the pool is empty.
+ */
+Arena_t CreateArenaFromPool(MemoryPool_t pool);
+
+
+/**
+ *  Delete an Arena, giving back its region if the Arena obtained it.
+ *
+ *  @param arena The Arena.
+ */
+void DeleteArena(Arena_t arena);
+
+
+/**
+ *  Allocate memory from an Arena.
+ *
+ *  @param arena The Arena.
+ *  @param Size How many bytes.
+ *  @param Alignment Power of 2 address boundary for the memory.
+ *  @return A pointer or NULL if the Arena is full.
+ */
+void *ArenaAllocate(Arena_t arena, int Size, int Alignment);
+
+
+/**
+ *  Free everything allocated from an Arena. This is O(1).
+ *
+ *  @param arena The Arena.
+ */
+void ArenaReset(Arena_t arena);
+
+
+/**
+ *  Remember the current position in an Arena.
+ *
+ *  @param arena The Arena.
+ *  @return An opaque marker for ArenaResetToMarker().
+ */
+int ArenaGetMarker(Arena_t arena);
+
+
+/**
+ *  Free everything allocated since a call to ArenaGetMarker(). Markers
+ *  can be nested, markers taken after this one are no longer valid.
+ *
+ *  @param arena The Arena.
+ *  @param Marker A marker from this Arena.
+ */
+void ArenaResetToMarker(Arena_t arena, int Marker);
+
+
+/**
+ *  @param arena The Arena.
+ *  @return How many bytes are currently allocated, including any
+ *  alignment padding.
+ */
+int ArenaGetBytesUsed(Arena_t arena);
+
+
+/**
+ *  @param arena The Arena.
+ *  @return How many bytes are left. Alignment padding can make less
+ *  than this usable.
+ */
+int ArenaGetBytesFree(Arena_t arena);
+
+
+#endif
@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef LOCK_FREE_MEM_POOL_H_
+#define LOCK_FREE_MEM_POOL_H_
+
+
+/**
+ *  Handle for lock free memory pools.
+ *
+ *  These are fixed allocation size memory areas, like a MemoryPool_t,
+ *  but the free list is managed with atomic compare and exchange 
+ *  operations instead of a mutex. Allocations and frees never block,
+ *  and can be done from either task or ISR context.
+ *
+ *  The pool is a single contiguous buffer, free items are tracked by 
+ *  index. The top of the free stack carries a tag which is changed on 
+ *  every operation, preventing the ABA problem.
+ *
+ *  @note This requires the compiler's __atomic builtins, and a target
+ *  with a native compare and exchange on a pointer sized word for the
+ *  operations to be truly lock free.
+ */
+typedef void * LockFreeMemoryPool_t;
+
+
+/**
+ *  Create a LockFreeMemoryPool
+ *
+ *  @param ItemSize How big is an allocation.
+ *  @param ItemCount What's the maximum number of allocations allowed?
+ *  This is limited to 65534 on 32 bit targets.
+ *  @param Alignment Power of 2 value denoting on which address boundary the 
+ *  memory will be aligned to. Must be at least sizeof(unsigned char *).
+ *  @return A Handle to the pool, or NULL on failure.
+ */
+LockFreeMemoryPool_t CreateLockFreeMemoryPool(  int ItemSize, 
+                                                int ItemCount,
+                                                int Alignment);
+
+
+/**
+ *  Create a LockFreeMemoryPool
+ *
+ *  @param ItemSize How big is an allocation.
+ *  @param PreallocatedMemory Pointer to the preallocated memory
+ *  you are dedicating to this pool.
+ *  @param PreallocatedMemorySize How big is the buffer you are
+ *  passing in.
+ *  @param Alignment Power of 2 value denoting on which address boundary the 
+ *  memory will be aligned to. Must be at least sizeof(unsigned char *).
+ *  @return A Handle to the pool, or NULL on failure.
+ */
+LockFreeMemoryPool_t CreateLockFreeMemoryPoolStatic(int ItemSize,
+                                                    void *PreallocatedMemory,
+                                                    int PreallocatedMemorySize,
+                                                    int Alignment);
+
+
+/**
+ *  There is no DeleteLockFreeMemoryPool() by design!
+ *
+ *  There is also no way to add memory to a LockFreeMemoryPool, 
+ *  items are tracked by their index into a single buffer.
+ */
+
+
+/**
+ *  Get a memory buffer from the pool.
+ *
+ *  This never blocks, and can be used from ISR context.
+ *
+ *  @param pool A handle to a LockFreeMemoryPool.
+ *  @return A pointer or NULL if the pool is empty.
+ */
+void *LockFreeMemoryPoolAllocate(LockFreeMemoryPool_t pool);
+
+
+/**
+ *  Return a memory buffer to the pool.
+ *
+ *  This never blocks, and can be used from ISR context.
+ *
+ *  @note There is no check that the memory passed in is valid.
+ *
+ *  @param pool A handle to a LockFreeMemoryPool.
+ *  @param memory memory obtained from LockFreeMemoryPoolAllocate().
+ */
+void LockFreeMemoryPoolFree(LockFreeMemoryPool_t pool, void *memory);
+
+
+#endif
+
@@ -44,6 +44,9 @@
 #define MEM_POOL_H_
 
 
+#include "FreeRTOS.h"
+
+
 /**
  *  Handle for memory pools. 
  *
@@ -52,6 +55,54 @@
 typedef void * MemoryPool_t;
 
 
+#ifdef C_FREERTOS_MEMORY_POOL_STATS
+/**
+ *  Snapshot of how full a MemoryPool is, and how full it has been.
+ *  Only available if C_FREERTOS_MEMORY_POOL_STATS is defined.
+ */
+typedef struct MemoryPoolStats_t_ {
+
+    /**
+     *  Total number of items the pool owns, free or not.
+     */
+    int TotalItems;
+
+    /**
+     *  Number of items currently free in the pool.
+     */
+    int FreeItems;
+
+    /**
+     *  The fewest free items the pool has ever had. If this is 
+     *  still comfortably above zero after a long run, the pool is 
+     *  bigger than it needs to be.
+     */
+    int LowWaterMark;
+
+    /**
+     *  The most items that have ever been allocated at once.
+     */
+    int PeakUsage;
+
+    /**
+     *  Total items handed out.
+     */
+    unsigned long Allocations;
+
+    /**
+     *  Total items returned.
+     */
+    unsigned long Frees;
+
+    /**
+     *  Allocations that returned NULL because the pool was empty.
+     */
+    unsigned long FailedAllocations;
+
+} MemoryPoolStats_t;
+#endif
+
+
 /**
  *  Create a MemoryPool
  *
@@ -118,7 +169,8 @@ int AddExtraMemoryToPoolStatic( MemoryPool_t pool,
 /**
  *  Get a memory buffer from the pool.
  *
- *  Note that this can block, and cannnot be used from ISR context.
+ *  Note that this uses a short critical section, and cannnot be used 
+ *  from ISR context. Use MemoryPoolAllocateFromISR() there.
  *
  *  @param pool A handle to a MemoryPool.
  *  @return A pointer or NULL on failure.
@@ -126,10 +178,27 @@ int AddExtraMemoryToPoolStatic( MemoryPool_t pool,
 void *MemoryPoolAllocate(MemoryPool_t pool);
 
 
+/**
+ *  Get a memory buffer from the pool, blocking if it is empty.
+ *
+ *  If the pool is empty, the calling task sleeps until another task 
+ *  or ISR returns a buffer, or the timeout expires. Each returned 
+ *  buffer wakes at most one blocked task. This cannot be used from 
+ *  ISR context.
+ *
+ *  @param pool A handle to a MemoryPool.
+ *  @param Timeout How long to wait for a buffer, in ticks. 0 is the
+ *  same as MemoryPoolAllocate(), portMAX_DELAY waits forever.
+ *  @return A pointer or NULL if the timeout expired.
+ */
+void *MemoryPoolAllocateWithTimeout(MemoryPool_t pool, TickType_t Timeout);
+
+
 /**
  *  Return a memory buffer to the pool.
  *
- *  @note This can block, and cannnot be used from ISR context.
+ *  @note This uses a short critical section, and cannnot be used from 
+ *  ISR context. Use MemoryPoolFreeFromISR() there.
  *  @note There is no check that the memory passed in is valid.
  *
  *  @param pool A handle to a MemoryPool.
@@ -138,5 +207,90 @@ void *MemoryPoolAllocate(MemoryPool_t pool);
 void MemoryPoolFree(MemoryPool_t pool, void *memory);
 
 
+/**
+ *  Get a memory buffer from the pool in ISR context.
+ *
+ *  Buffers may be freely passed between ISRs and tasks, an ISR can 
+ *  fill a buffer and hand ownership to a task, which later returns it
+ *  with MemoryPoolFree().
+ *
+ *  @param pool A handle to a MemoryPool.
+ *  @return A pointer or NULL on failure.
+ */
+void *MemoryPoolAllocateFromISR(MemoryPool_t pool);
+
+
+/**
+ *  Return a memory buffer to the pool in ISR context.
+ *
+ *  @note There is no check that the memory passed in is valid.
+ *
+ *  @param pool A handle to a MemoryPool.
+ *  @param memory memory obtained from one of the Allocate functions.
+ *  @param pxHigherPriorityTaskWoken Set to pdTRUE if returning the 
+ *  buffer woke a task blocked in MemoryPoolAllocateWithTimeout() with 
+ *  a higher priority than the interrupted task. May be NULL.
+ */
+void MemoryPoolFreeFromISR( MemoryPool_t pool, 
+                            void *memory,
+                            BaseType_t *pxHigherPriorityTaskWoken);
+
+
+/**
+ *  Get up to count memory buffers from the pool in a single critical
+ *  section, rather than one per buffer.
+ *
+ *  Interrupts are masked while the buffers are taken, so keep count
+ *  reasonably small. This cannot be used from ISR context.
+ *
+ *  @param pool A handle to a MemoryPool.
+ *  @param items Array of at least count pointers to fill in.
+ *  @param count How many buffers are wanted.
+ *  @return How many buffers were actually allocated, these are in 
+ *  items[0] up to items[return value - 1]. This can be less than 
+ *  count if the pool runs out.
+ */
+int MemoryPoolAllocateBatch(MemoryPool_t pool, void **items, int count);
+
+
+/**
+ *  Return count memory buffers to the pool in a single critical 
+ *  section, rather than one per buffer.
+ *
+ *  @note This cannot be used from ISR context.
+ *  @note There is no check that the memory passed in is valid.
+ *
+ *  @param pool A handle to a MemoryPool.
+ *  @param items Array of count buffers obtained from this pool.
+ *  @param count How many buffers to free.
+ */
+void MemoryPoolFreeBatch(MemoryPool_t pool, void **items, int count);
+
+
+/**
+ *  Get the usable size of each buffer in the pool. This may be more
+ *  than was asked for when the pool was created.
+ *
+ *  @param pool A handle to a MemoryPool.
+ *  @return The buffer size in bytes.
+ */
+int MemoryPoolGetItemSize(MemoryPool_t pool);
+
+
+#ifdef C_FREERTOS_MEMORY_POOL_STATS
+/**
+ *  Get the pool statistics.
+ *
+ *  This does not enter the pool's critical section, each field is 
+ *  read atomically on its own, so it is cheap enough to call from a
+ *  monitoring task or ISR.
+ *
+ *  @param pool A handle to a MemoryPool.
+ *  @param stats Where to put the snapshot.
+ */
+void MemoryPoolGetStats(MemoryPool_t pool, MemoryPoolStats_t *stats);
+#endif
+
+
 #endif
 
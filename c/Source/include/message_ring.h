@@ -0,0 +1,190 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef MESSAGE_RING_H_
+#define MESSAGE_RING_H_
+
+
+#include "FreeRTOS.h"
+
+
+/**
+ *  Handle for message rings.
+ *
+ *  A message ring passes variable length messages through one 
+ *  contiguous byte buffer without copying them. The producer reserves
+ *  space, writes the message in place and commits it. The consumer 
+ *  peeks at the oldest message in place and releases it when done.
+ *  Each message costs one length word on top of its data, rounded 
+ *  up to pointer alignment, and every message pointer is pointer 
+ *  aligned.
+ *
+ *  A message ring has exactly one producer and one consumer. They may
+ *  be any mix of tasks and ISRs, and they never lock each other out.
+ *  Only one reservation can be outstanding at a time.
+ */
+typedef void * MessageRing_t;
+
+
+/**
+ *  Create a MessageRing, using malloc for the buffer.
+ *
+ *  @param Size How many bytes the ring holds, including the length 
+ *  words. The largest message is a little under half of this, which
+ *  guarantees it always fits once the ring drains.
+ *  @return A Handle to the MessageRing, or NULL on failure.
+ */
+MessageRing_t CreateMessageRing(int Size);
+
+
+/**
+ *  Create a MessageRing using memory you pass in for the buffer.
+ *
+ *  @param Buffer Pointer to the preallocated memory, aligned to at 
+ *  least sizeof(void *).
+ *  @param Size How big is the buffer you are passing in. The largest
+ *  message is a little under half of this.
+ *  @return A Handle to the MessageRing, or NULL on failure.
+ */
+MessageRing_t CreateMessageRingStatic(void *Buffer, int Size);
+
+
+/**
+ *  Delete a MessageRing, freeing its buffer if the ring allocated it.
+ *
+ *  @param ring The MessageRing.
+ */
+void DeleteMessageRing(MessageRing_t ring);
+
+
+/**
+ *  Reserve space for a message, waiting for the consumer to release
+ *  older messages if the ring is full.
+ *
+ *  @param ring The MessageRing.
+ *  @param Size How many bytes the message needs.
+ *  @param Timeout Timeout in FreeRTOS ticks.
+ *  @return Where to write the message, or NULL on timeout or if the 
+ *  message could never fit.
+ */
+void *MessageRingReserve(MessageRing_t ring, int Size, TickType_t Timeout);
+
+
+/**
+ *  Reserve space for a message, from ISR context. Does not wait.
+ *
+ *  @param ring The MessageRing.
+ *  @param Size How many bytes the message needs.
+ *  @return Where to write the message, or NULL if there is no room.
+ */
+void *MessageRingReserveFromISR(MessageRing_t ring, int Size);
+
+
+/**
+ *  Publish the message written into the last reservation.
+ *
+ *  @param ring The MessageRing.
+ *  @param Size The actual size of the message, which may be smaller 
+ *  than what was reserved. Any unused space is given back.
+ */
+void MessageRingCommit(MessageRing_t ring, int Size);
+
+
+/**
+ *  Publish the message written into the last reservation, from 
+ *  ISR context.
+ *
+ *  @param ring The MessageRing.
+ *  @param Size The actual size of the message, which may be smaller 
+ *  than what was reserved.
+ *  @param pxHigherPriorityTaskWoken Set to pdTRUE if this unblocked
+ *  a higher priority task, may be NULL.
+ */
+void MessageRingCommitFromISR(  MessageRing_t ring, 
+                                int Size, 
+                                BaseType_t *pxHigherPriorityTaskWoken);
+
+
+/**
+ *  Look at the oldest message, waiting for one if the ring is empty.
+ *  The message stays in the ring until MessageRingRelease().
+ *
+ *  @param ring The MessageRing.
+ *  @param Size Receives the size of the message.
+ *  @param Timeout Timeout in FreeRTOS ticks.
+ *  @return The message, or NULL on timeout.
+ */
+void *MessageRingPeek(MessageRing_t ring, int *Size, TickType_t Timeout);
+
+
+/**
+ *  Look at the oldest message, from ISR context. Does not wait.
+ *
+ *  @param ring The MessageRing.
+ *  @param Size Receives the size of the message.
+ *  @return The message, or NULL if the ring is empty.
+ */
+void *MessageRingPeekFromISR(MessageRing_t ring, int *Size);
+
+
+/**
+ *  Give the space used by the message from the last successful 
+ *  peek back to the producer.
+ *
+ *  @param ring The MessageRing.
+ */
+void MessageRingRelease(MessageRing_t ring);
+
+
+/**
+ *  Give the space used by the message from the last successful 
+ *  peek back to the producer, from ISR context.
+ *
+ *  @param ring The MessageRing.
+ *  @param pxHigherPriorityTaskWoken Set to pdTRUE if this unblocked
+ *  a higher priority task, may be NULL.
+ */
+void MessageRingReleaseFromISR( MessageRing_t ring, 
+                                BaseType_t *pxHigherPriorityTaskWoken);
+
+
+#endif
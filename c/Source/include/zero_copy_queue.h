@@ -43,6 +43,7 @@
 #ifndef ZERO_COPY_QUEUE_H_
 #define ZERO_COPY_QUEUE_H_
 
+#include "FreeRTOS.h"
 
 /**
  *  Handle for ZeroCopyQueues. 
@@ -112,5 +113,106 @@ int ZcqEnqueueItem(ZeroCopyQueue_t zcq, void *item, TickType_t Timeout);
 void *ZcqDequeueItem(ZeroCopyQueue_t zcq, TickType_t Timeout);
 
 
+/**
+ *  Allocate an item to use or queue, from ISR context.
+ *
+ *  @param zcq A handle to a ZeroCopyQueue_t.
+ *  @return A pointer or NULL on failure.
+ */
+void *ZcqAllocateItemFromISR(ZeroCopyQueue_t zcq);
+
+
+/**
+ *  Free a previously allocated item back into the base pool,
+ *  from ISR context.
+ *
+ *  @param zcq A handle to a ZeroCopyQueue_t.
+ *  @param item An item obtained from ZcqAllocateItem().
+ *  @param pxHigherPriorityTaskWoken Set to pdTRUE if freeing the item
+ *  unblocked a higher priority task, may be NULL.
+ */
+void ZcqFreeItemFromISR(ZeroCopyQueue_t zcq, 
+                        void *item, 
+                        BaseType_t *pxHigherPriorityTaskWoken);
+
+
+/**
+ *  Queue an item obtained from ZcqAllocateItem(), from ISR context.
+ *
+ *  @param zcq A handle to a ZeroCopyQueue_t.
+ *  @param item An item obtained from ZcqAllocateItem().
+ *  @param pxHigherPriorityTaskWoken Set to pdTRUE if queueing the item
+ *  unblocked a higher priority task, may be NULL.
+ *  @return 1 on success, 0 if the queue is full.
+ */
+int ZcqEnqueueItemFromISR(  ZeroCopyQueue_t zcq, 
+                            void *item, 
+                            BaseType_t *pxHigherPriorityTaskWoken);
+
+
+/**
+ *  Dequeue an item from ZcqEnqueueItem(), from ISR context.
+ *
+ *  @param zcq A handle to a ZeroCopyQueue_t.
+ *  @param pxHigherPriorityTaskWoken Set to pdTRUE if dequeueing the item
+ *  unblocked a higher priority task, may be NULL.
+ *  @return An item obtained from ZcqAllocateItem() on success.
+ *  NULL if the queue is empty.
+ */
+void *ZcqDequeueItemFromISR(ZeroCopyQueue_t zcq, 
+                            BaseType_t *pxHigherPriorityTaskWoken);
+
+
+/**
+ *  Queue several items obtained from ZcqAllocateItem(), in order.
+ *
+ *  @param zcq A handle to a ZeroCopyQueue_t.
+ *  @param items Array of items to queue.
+ *  @param count How many items are in the array.
+ *  @param Timeout Timeout in FreeRTOS ticks, for the whole batch.
+ *  @return How many items were queued, starting from items[0]. 
+ *  The rest still belong to the caller.
+ */
+int ZcqEnqueueBatch(ZeroCopyQueue_t zcq, 
+                    void **items, 
+                    int count, 
+                    TickType_t Timeout);
+
+
+/**
+ *  Queue several items obtained from ZcqAllocateItem(), in order,
+ *  from ISR context.
+ *
+ *  @param zcq A handle to a ZeroCopyQueue_t.
+ *  @param items Array of items to queue.
+ *  @param count How many items are in the array.
+ *  @param pxHigherPriorityTaskWoken Set to pdTRUE if queueing the items
+ *  unblocked a higher priority task, may be NULL.
+ *  @return How many items were queued, starting from items[0]. 
+ *  The rest still belong to the caller.
+ */
+int ZcqEnqueueBatchFromISR( ZeroCopyQueue_t zcq, 
+                            void **items, 
+                            int count, 
+                            BaseType_t *pxHigherPriorityTaskWoken);
+
+
+/**
+ *  Dequeue up to count items at once. This waits for the first
+ *  item only, then takes whatever else is already queued, so a 
+ *  burst of items costs the receiver a single wake up.
+ *
+ *  @param zcq A handle to a ZeroCopyQueue_t.
+ *  @param items Array to receive the items.
+ *  @param count Size of the array.
+ *  @param Timeout Timeout in FreeRTOS ticks, for the first item.
+ *  @return How many items were dequeued, 0 on timeout.
+ */
+int ZcqDequeueBatch(ZeroCopyQueue_t zcq, 
+                    void **items, 
+                    int count, 
+                    TickType_t Timeout);
+
+
 #endif
 
@@ -0,0 +1,320 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "lock_free_mem_pool.h"
+
+
+/**
+ *  The top of the free stack is a single word. The low half holds 
+ *  the index of the top item plus one (0 means empty), the high half 
+ *  holds a tag that is bumped on every push and pop.
+ */
+#define LF_INDEX_BITS   (sizeof(uintptr_t) * 4)
+#define LF_INDEX_MASK   ((((uintptr_t)1) << LF_INDEX_BITS) - 1)
+#define LF_TAG_ONE      (((uintptr_t)1) << LF_INDEX_BITS)
+
+
+/**
+ *  The actual Lock Free Memory Pool data structure.
+ */
+typedef struct LfMemPool_t_ {
+
+    /**
+     *  Tagged index of the top free item.
+     */
+    uintptr_t Top;
+
+    /**
+     *  Size of each item, a multiple of the alignment.
+     */
+    int ItemSize;
+
+    /**
+     *  How many items are in the Buffer.
+     */
+    int ItemCount;
+
+    /**
+     *  The aligned beginning of the items.
+     */
+    unsigned char *Buffer;
+
+} LfMemPool_t;
+
+
+static int CalculateAndVerifyAlignment(int Alignment)
+{
+    /*********************************/
+    int i;
+    int alignmentBit = 0x1;
+    /*********************************/
+
+    /**
+     *  Guarantee that the alignment is the size of a pointer.
+     */
+    if (Alignment < (int)sizeof(unsigned char *)) {
+        Alignment = (int)sizeof(unsigned char *);
+    }
+
+    for (i = 0; i < 31; i++) {
+        if (Alignment == alignmentBit) {
+            break;
+        }
+        alignmentBit <<= 1; 
+    }
+
+    if (i >= 31) {
+        return 0;
+    }
+    else {
+        return Alignment;
+    }
+}
+
+
+static int CalculateItemSize(   int ItemSize,
+                                int Alignment)
+{
+    /**
+     *  No header is needed, while an item is free its first 
+     *  word holds the link to the next free item.
+     */
+    if (ItemSize <= Alignment) {
+        return Alignment;
+    }
+    else {
+        return ((ItemSize + Alignment - 1) / Alignment) * Alignment;
+    }
+}
+
+
+static void InitLfMemPool(  LfMemPool_t *MemPool,
+                            unsigned char *Buffer,
+                            int ItemSize,
+                            int ItemCount)
+{
+    /*********************************/
+    int i;
+    /*********************************/
+
+    MemPool->ItemSize = ItemSize;
+    MemPool->ItemCount = ItemCount;
+    MemPool->Buffer = Buffer;
+
+    /**
+     *  Item i links to item i + 1, the last one links to "empty".
+     */
+    for (i = 0; i < ItemCount; i++) {
+        *(uintptr_t *)(Buffer + (i * ItemSize)) = 
+            (i + 1 < ItemCount) ? (uintptr_t)(i + 2) : 0;
+    }
+
+    MemPool->Top = (ItemCount > 0) ? 1 : 0;
+}
+
+
+static unsigned char *AlignUp(  unsigned char *ptr, 
+                                int Alignment)
+{
+    uintptr_t address = (uintptr_t)ptr;
+
+    address = (address + Alignment - 1) & ~((uintptr_t)Alignment - 1);
+
+    return (unsigned char *)address;
+}
+
+
+LockFreeMemoryPool_t CreateLockFreeMemoryPool(  int ItemSize,
+                                                int ItemCount,
+                                                int Alignment)
+{
+    /*********************************/
+    LfMemPool_t *MemPool;
+    /*********************************/
+
+    Alignment = CalculateAndVerifyAlignment(Alignment);
+
+    if (Alignment == 0) {
+        return NULL;
+    }
+
+    if (ItemCount < 0 || (uintptr_t)ItemCount >= LF_INDEX_MASK) {
+        return NULL;
+    }
+
+    ItemSize = CalculateItemSize(ItemSize, Alignment);
+
+    /**
+     *  Over allocate so we can align the first item.
+     */
+    MemPool = (LfMemPool_t *)malloc(sizeof(LfMemPool_t) 
+                                    + Alignment
+                                    + (ItemCount * ItemSize));
+    if (!MemPool) {
+        return NULL;
+    }
+
+    InitLfMemPool(  MemPool, 
+                    AlignUp((unsigned char *)(MemPool + 1), Alignment),
+                    ItemSize,
+                    ItemCount);
+
+    return (LockFreeMemoryPool_t)MemPool;
+}
+
+
+LockFreeMemoryPool_t CreateLockFreeMemoryPoolStatic(int ItemSize,
+                                                    void *PreallocatedMemory,
+                                                    int PreallocatedMemorySize,
+                                                    int Alignment)
+{
+    /*********************************/
+    LfMemPool_t *MemPool;
+    unsigned char *Buffer;
+    int ItemCount;
+    /*********************************/
+
+    Alignment = CalculateAndVerifyAlignment(Alignment);
+
+    if (Alignment == 0) {
+        return NULL;
+    }
+
+    ItemSize = CalculateItemSize(ItemSize, Alignment);
+
+    Buffer = AlignUp((unsigned char *)PreallocatedMemory, Alignment);
+    PreallocatedMemorySize -= (int)(Buffer - (unsigned char *)PreallocatedMemory);
+
+    ItemCount = PreallocatedMemorySize > 0 ? 
+                    PreallocatedMemorySize / ItemSize : 0;
+
+    if ((uintptr_t)ItemCount >= LF_INDEX_MASK) {
+        return NULL;
+    }
+
+    MemPool = (LfMemPool_t *)malloc(sizeof(LfMemPool_t));
+    if (!MemPool) {
+        return NULL;
+    }
+
+    InitLfMemPool(MemPool, Buffer, ItemSize, ItemCount);
+
+    return (LockFreeMemoryPool_t)MemPool;
+}
+
+
+void *LockFreeMemoryPoolAllocate(LockFreeMemoryPool_t pool)
+{
+    /*********************************/
+    LfMemPool_t *MemPool;
+    uintptr_t OldTop;
+    uintptr_t NewTop;
+    uintptr_t Next;
+    unsigned char *Item;
+    /*********************************/
+
+    MemPool = (LfMemPool_t *)pool;
+
+    OldTop = __atomic_load_n(&MemPool->Top, __ATOMIC_ACQUIRE);
+
+    do {
+        if ((OldTop & LF_INDEX_MASK) == 0) {
+            return NULL;
+        }
+
+        Item = MemPool->Buffer 
+                + (((OldTop & LF_INDEX_MASK) - 1) * MemPool->ItemSize);
+
+        /**
+         *  If someone else pops this item first, Next may be stale,
+         *  but then the tag has changed and the exchange will fail.
+         */
+        Next = __atomic_load_n((uintptr_t *)Item, __ATOMIC_RELAXED);
+
+        NewTop = ((OldTop & ~LF_INDEX_MASK) + LF_TAG_ONE) | Next;
+
+    } while (!__atomic_compare_exchange_n(  &MemPool->Top, 
+                                            &OldTop, 
+                                            NewTop, 
+                                            1,
+                                            __ATOMIC_ACQUIRE,
+                                            __ATOMIC_ACQUIRE));
+
+    return (void *)Item;
+}
+
+
+void LockFreeMemoryPoolFree(LockFreeMemoryPool_t pool, void *memory)
+{
+    /*********************************/
+    LfMemPool_t *MemPool;
+    uintptr_t OldTop;
+    uintptr_t NewTop;
+    uintptr_t Index;
+    /*********************************/
+
+    MemPool = (LfMemPool_t *)pool;
+
+    Index = (uintptr_t)(((unsigned char *)memory - MemPool->Buffer) 
+                            / MemPool->ItemSize) + 1;
+
+    OldTop = __atomic_load_n(&MemPool->Top, __ATOMIC_RELAXED);
+
+    do {
+        __atomic_store_n(   (uintptr_t *)memory, 
+                            OldTop & LF_INDEX_MASK, 
+                            __ATOMIC_RELAXED);
+
+        NewTop = ((OldTop & ~LF_INDEX_MASK) + LF_TAG_ONE) | Index;
+
+    } while (!__atomic_compare_exchange_n(  &MemPool->Top, 
+                                            &OldTop, 
+                                            NewTop, 
+                                            1,
+                                            __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED));
+}
+
+
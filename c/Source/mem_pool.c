@@ -41,7 +41,9 @@
 
 
 #include <stdlib.h>
+#include <stdint.h>
 #include "FreeRTOS.h"
+#include "task.h"
 #include "semphr.h"
 #include "mem_pool.h"
 #include "stack_simple.h"
@@ -54,11 +56,6 @@
  */
 typedef struct MemPool_t_ {
 
-    /**
-     *  We need a lock to make this thread safe.
-     */
-    SemaphoreHandle_t Lock;
-    
     /**
      *  Memory blocks are stored on a stack.
      */
@@ -74,6 +71,27 @@ typedef struct MemPool_t_ {
      */
     int Alignment;
 
+    /**
+     *  Given once for each task that must be woken because a
+     *  buffer was returned.
+     */
+    SemaphoreHandle_t ItemFreed;
+
+    /**
+     *  How many tasks are blocked in MemoryPoolAllocateWithTimeout()
+     *  and have not been woken yet. Protected by the critical section.
+     */
+    int Waiters;
+
+#ifdef C_FREERTOS_MEMORY_POOL_STATS
+    /**
+     *  Running statistics. Only ever written inside the pool's
+     *  critical section, and only ever with atomic stores, so 
+     *  MemoryPoolGetStats() can read them without locking.
+     */
+    MemoryPoolStats_t Stats;
+#endif
+
     /**
      *  The begining of the actual memory pool itself.
      */
@@ -82,6 +100,151 @@ typedef struct MemPool_t_ {
 } MemPool_t;
 
 
+/**
+ *  The wake up semaphore is never given more times than there are
+ *  blocked tasks, so any limit comfortably above the task count works.
+ */
+#define MAX_WAITERS     0x7FFF
+
+
+/**
+ *  Claim up to Count waiters to wake. Must be called from inside 
+ *  the pool's critical section.
+ */
+static int ClaimWaiters(MemPool_t *MemPool, int Count)
+{
+    /*********************************/
+    int Wake;
+    /*********************************/
+
+    Wake = MemPool->Waiters < Count ? MemPool->Waiters : Count;
+    MemPool->Waiters -= Wake;
+
+    return Wake;
+}
+
+
+/**
+ *  Wake the tasks claimed by ClaimWaiters(). Must be called from
+ *  outside of the critical section.
+ */
+static void WakeWaiters(MemPool_t *MemPool, int Count)
+{
+    while (Count-- > 0) {
+        xSemaphoreGive(MemPool->ItemFreed);
+    }
+}
+
+
+/**
+ *  Statistics bookkeeping. These compile away to nothing unless 
+ *  C_FREERTOS_MEMORY_POOL_STATS is defined, and must be called from 
+ *  inside the pool's critical section.
+ */
+#ifdef C_FREERTOS_MEMORY_POOL_STATS
+
+static void StatsInit(MemPool_t *MemPool)
+{
+    MemPool->Stats.TotalItems = 0;
+    MemPool->Stats.FreeItems = 0;
+    MemPool->Stats.LowWaterMark = 0;
+    MemPool->Stats.PeakUsage = 0;
+    MemPool->Stats.Allocations = 0;
+    MemPool->Stats.Frees = 0;
+    MemPool->Stats.FailedAllocations = 0;
+}
+
+
+static void StatsAdded(MemPool_t *MemPool, int Count)
+{
+    /*********************************/
+    MemoryPoolStats_t *Stats;
+    /*********************************/
+
+    Stats = &MemPool->Stats;
+
+    /**
+     *  Until the first allocation the low water mark simply
+     *  tracks how much memory the pool has been given.
+     */
+    if (Stats->Allocations == 0) {
+        __atomic_store_n(&Stats->LowWaterMark, Stats->FreeItems + Count, __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&Stats->TotalItems, Stats->TotalItems + Count, __ATOMIC_RELAXED);
+    __atomic_store_n(&Stats->FreeItems, Stats->FreeItems + Count, __ATOMIC_RELAXED);
+}
+
+
+static void StatsAllocated(MemPool_t *MemPool, int Count)
+{
+    /*********************************/
+    MemoryPoolStats_t *Stats;
+    int FreeItems;
+    int InUse;
+    /*********************************/
+
+    Stats = &MemPool->Stats;
+
+    if (Count == 0) {
+        return;
+    }
+
+    FreeItems = Stats->FreeItems - Count;
+    InUse = Stats->TotalItems - FreeItems;
+
+    __atomic_store_n(&Stats->FreeItems, FreeItems, __ATOMIC_RELAXED);
+    __atomic_store_n(&Stats->Allocations, Stats->Allocations + Count, __ATOMIC_RELAXED);
+
+    if (FreeItems < Stats->LowWaterMark) {
+        __atomic_store_n(&Stats->LowWaterMark, FreeItems, __ATOMIC_RELAXED);
+    }
+
+    if (InUse > Stats->PeakUsage) {
+        __atomic_store_n(&Stats->PeakUsage, InUse, __ATOMIC_RELAXED);
+    }
+}
+
+
+static void StatsFailed(MemPool_t *MemPool, int Count)
+{
+    /*********************************/
+    MemoryPoolStats_t *Stats;
+    /*********************************/
+
+    Stats = &MemPool->Stats;
+
+    if (Count == 0) {
+        return;
+    }
+
+    __atomic_store_n(&Stats->FailedAllocations, Stats->FailedAllocations + Count, __ATOMIC_RELAXED);
+}
+
+
+static void StatsFreed(MemPool_t *MemPool, int Count)
+{
+    /*********************************/
+    MemoryPoolStats_t *Stats;
+    /*********************************/
+
+    Stats = &MemPool->Stats;
+
+    __atomic_store_n(&Stats->FreeItems, Stats->FreeItems + Count, __ATOMIC_RELAXED);
+    __atomic_store_n(&Stats->Frees, Stats->Frees + Count, __ATOMIC_RELAXED);
+}
+
+#else
+
+#define StatsInit(_pool)
+#define StatsAdded(_pool, _count)
+#define StatsAllocated(_pool, _count)
+#define StatsFailed(_pool, _count)
+#define StatsFreed(_pool, _count)
+
+#endif
+
+
 static int CalculateAndVerifyAlignment(int Alignment)
 {
     /*********************************/
@@ -160,16 +323,20 @@ MemoryPool_t CreateMemoryPool(  int ItemSize,
 
     ItemSize = CalculateItemSize(ItemSize, Alignment);
 
+    /**
+     *  The extra Alignment - 1 bytes let us line the first item up
+     *  on an Alignment boundary, wherever Buffer lands.
+     */
     MemPoolSize = sizeof(MemPool_t) - sizeof(unsigned char)
-                    + (ItemCount * ItemSize);
+                    + (ItemCount * ItemSize) + (Alignment - 1);
 
     MemPool = (MemPool_t *)malloc(MemPoolSize);
     if (!MemPool) {
         return NULL;
     }
 
-    MemPool->Lock = xSemaphoreCreateMutex();
-    if (MemPool->Lock == NULL) {
+    MemPool->ItemFreed = xSemaphoreCreateCounting(MAX_WAITERS, 0);
+    if (MemPool->ItemFreed == NULL) {
         free(MemPool);
         return NULL;
     }
@@ -177,8 +344,11 @@ MemoryPool_t CreateMemoryPool(  int ItemSize,
     InitStack(&MemPool->Stack);
     MemPool->ItemSize = ItemSize;
     MemPool->Alignment = Alignment;
+    MemPool->Waiters = 0;
+    StatsInit(MemPool);
 
-    ptr = MemPool->Buffer;
+    ptr = (unsigned char *)(((uintptr_t)MemPool->Buffer + (Alignment - 1))
+                            & ~(uintptr_t)(Alignment - 1));
 
     for (i = 0; i < ItemCount; i++) {
         
@@ -188,6 +358,8 @@ MemoryPool_t CreateMemoryPool(  int ItemSize,
 
         ptr += MemPool->ItemSize;
     }
+
+    StatsAdded(MemPool, ItemCount);
     
     return (MemoryPool_t)MemPool;
 }
@@ -202,6 +374,7 @@ int AddExtraMemoryToPool(   MemoryPool_t pool,
     unsigned char *ptr;
     int i;
     int AdditionalPoolSize;
+    int Wake;
     /*********************************/
 
     MemPool = (MemPool_t *)pool;
@@ -217,11 +390,15 @@ int AddExtraMemoryToPool(   MemoryPool_t pool,
         
         Node = (SlNode_t *)ptr;
     
-        xSemaphoreTake(MemPool->Lock, portMAX_DELAY);
+        taskENTER_CRITICAL();
         
         PushOnStack(&MemPool->Stack, Node);
+        StatsAdded(MemPool, 1);
+        Wake = ClaimWaiters(MemPool, 1);
 
-        xSemaphoreGive(MemPool->Lock);
+        taskEXIT_CRITICAL();
+
+        WakeWaiters(MemPool, Wake);
     
         ptr += MemPool->ItemSize;
     }
@@ -257,8 +434,8 @@ MemoryPool_t CreateMemoryPoolStatic(int ItemSize,
         return NULL;
     }
 
-    MemPool->Lock = xSemaphoreCreateMutex();
-    if (MemPool->Lock == NULL) {
+    MemPool->ItemFreed = xSemaphoreCreateCounting(MAX_WAITERS, 0);
+    if (MemPool->ItemFreed == NULL) {
         free(MemPool);
         return NULL;
     }
@@ -266,6 +443,8 @@ MemoryPool_t CreateMemoryPoolStatic(int ItemSize,
     InitStack(&MemPool->Stack);
     MemPool->ItemSize = ItemSize;
     MemPool->Alignment = Alignment;
+    MemPool->Waiters = 0;
+    StatsInit(MemPool);
 
     ptr = (unsigned char *)PreallocatedMemory;
 
@@ -273,6 +452,7 @@ MemoryPool_t CreateMemoryPoolStatic(int ItemSize,
         
         Node = (SlNode_t *)ptr;
         PushOnStack(&MemPool->Stack, Node);
+        StatsAdded(MemPool, 1);
         ptr += MemPool->ItemSize;
         PreallocatedMemorySize -= MemPool->ItemSize;
     }
@@ -289,6 +469,7 @@ int AddExtraMemoryToPoolStatic( MemoryPool_t pool,
     MemPool_t *MemPool;
     SlNode_t *Node;
     unsigned char *ptr;
+    int Wake;
     /*********************************/
 
     MemPool = (MemPool_t *)pool;
@@ -298,13 +479,18 @@ int AddExtraMemoryToPoolStatic( MemoryPool_t pool,
 
         Node = (SlNode_t *)ptr;
 
-        xSemaphoreTake(MemPool->Lock, portMAX_DELAY);
+        taskENTER_CRITICAL();
         
         PushOnStack(&MemPool->Stack, Node);
+        StatsAdded(MemPool, 1);
+        Wake = ClaimWaiters(MemPool, 1);
+
+        taskEXIT_CRITICAL();
 
-        xSemaphoreGive(MemPool->Lock);
+        WakeWaiters(MemPool, Wake);
 
         ptr += MemPool->ItemSize;
+        PreallocatedMemorySize -= MemPool->ItemSize;
     }
 
     return pdPASS;
@@ -316,25 +502,104 @@ void *MemoryPoolAllocate(MemoryPool_t pool)
     /*********************************/
     MemPool_t *MemPool;
     SlNode_t *Node;
-    unsigned char *ptr;
     /*********************************/
 
     MemPool = (MemPool_t *)pool;
 
-    xSemaphoreTake(MemPool->Lock, portMAX_DELAY);
+    taskENTER_CRITICAL();
+
+    Node = PopOffStack(&MemPool->Stack);
 
-    if (MemPool->Stack.Count == 0) {
-        xSemaphoreGive(MemPool->Lock);
+    if (Node != NULL) {
+        StatsAllocated(MemPool, 1);
+    }
+    else {
+        StatsFailed(MemPool, 1);
+    }
+
+    taskEXIT_CRITICAL();
+
+    if (Node == NULL) {
         return NULL;
     }
 
-    Node = PopOffStack(&MemPool->Stack);
+    return (void *)(((unsigned char *)Node) + MemPool->Alignment);
+}
 
-    xSemaphoreGive(MemPool->Lock);
 
-    ptr = ((unsigned char *)Node) + MemPool->Alignment;
+void *MemoryPoolAllocateWithTimeout(MemoryPool_t pool, TickType_t Timeout)
+{
+    /*********************************/
+    MemPool_t *MemPool;
+    SlNode_t *Node;
+    TimeOut_t TimeOut;
+    int Claimed;
+    /*********************************/
+
+    MemPool = (MemPool_t *)pool;
 
-    return (void *)ptr;
+    vTaskSetTimeOutState(&TimeOut);
+
+    while (1) {
+
+        taskENTER_CRITICAL();
+
+        Node = PopOffStack(&MemPool->Stack);
+
+        if (Node != NULL) {
+            StatsAllocated(MemPool, 1);
+        }
+        else if (Timeout != 0) {
+            MemPool->Waiters++;
+        }
+        else {
+            StatsFailed(MemPool, 1);
+        }
+
+        taskEXIT_CRITICAL();
+
+        if (Node != NULL) {
+            return (void *)(((unsigned char *)Node) + MemPool->Alignment);
+        }
+
+        if (Timeout == 0) {
+            return NULL;
+        }
+
+        if (xSemaphoreTake(MemPool->ItemFreed, Timeout) == pdTRUE) {
+            /**
+             *  Something was returned, but another task may still
+             *  beat us to it, so go around again with what's left.
+             */
+            if (xTaskCheckForTimeOut(&TimeOut, &Timeout) != pdFALSE) {
+                Timeout = 0;
+            }
+            continue;
+        }
+
+        /**
+         *  Timed out. Take ourselves off the waiter count, unless a
+         *  free already claimed us, in which case its give is on the
+         *  way and has to be consumed to keep the semaphore balanced.
+         */
+        taskENTER_CRITICAL();
+
+        Claimed = (MemPool->Waiters == 0);
+        if (!Claimed) {
+            MemPool->Waiters--;
+        }
+
+        taskEXIT_CRITICAL();
+
+        if (Claimed) {
+            xSemaphoreTake(MemPool->ItemFreed, portMAX_DELAY);
+        }
+
+        /**
+         *  One last non blocking try.
+         */
+        Timeout = 0;
+    }
 }
 
 
@@ -343,21 +608,175 @@ void MemoryPoolFree(MemoryPool_t pool, void *memory)
     /*********************************/
     MemPool_t *MemPool;
     SlNode_t *Node;
-    unsigned char *ptr;
+    int Wake;
     /*********************************/
 
     MemPool = (MemPool_t *)pool;
 
-    ptr = ((unsigned char *)memory) - MemPool->Alignment;
+    Node = (SlNode_t *)(((unsigned char *)memory) - MemPool->Alignment);
+
+    taskENTER_CRITICAL();
 
-    Node = (SlNode_t *)ptr;
+    PushOnStack(&MemPool->Stack, Node);
+    StatsFreed(MemPool, 1);
+    Wake = ClaimWaiters(MemPool, 1);
 
-    xSemaphoreTake(MemPool->Lock, portMAX_DELAY);
+    taskEXIT_CRITICAL();
+
+    WakeWaiters(MemPool, Wake);
+}
+
+
+void *MemoryPoolAllocateFromISR(MemoryPool_t pool)
+{
+    /*********************************/
+    MemPool_t *MemPool;
+    SlNode_t *Node;
+    UBaseType_t SavedInterruptStatus;
+    /*********************************/
+
+    MemPool = (MemPool_t *)pool;
+
+    SavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+
+    Node = PopOffStack(&MemPool->Stack);
+
+    if (Node != NULL) {
+        StatsAllocated(MemPool, 1);
+    }
+    else {
+        StatsFailed(MemPool, 1);
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(SavedInterruptStatus);
+
+    if (Node == NULL) {
+        return NULL;
+    }
+
+    return (void *)(((unsigned char *)Node) + MemPool->Alignment);
+}
+
+
+void MemoryPoolFreeFromISR(   MemoryPool_t pool, 
+                              void *memory,
+                              BaseType_t *pxHigherPriorityTaskWoken)
+{
+    /*********************************/
+    MemPool_t *MemPool;
+    SlNode_t *Node;
+    UBaseType_t SavedInterruptStatus;
+    int Wake;
+    /*********************************/
+
+    MemPool = (MemPool_t *)pool;
+
+    Node = (SlNode_t *)(((unsigned char *)memory) - MemPool->Alignment);
+
+    SavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 
     PushOnStack(&MemPool->Stack, Node);
+    StatsFreed(MemPool, 1);
+    Wake = ClaimWaiters(MemPool, 1);
+
+    taskEXIT_CRITICAL_FROM_ISR(SavedInterruptStatus);
 
-    xSemaphoreGive(MemPool->Lock);
+    if (Wake) {
+        xSemaphoreGiveFromISR(MemPool->ItemFreed, pxHigherPriorityTaskWoken);
+    }
 }
 
 
+int MemoryPoolAllocateBatch(MemoryPool_t pool, void **items, int count)
+{
+    /*********************************/
+    MemPool_t *MemPool;
+    SlNode_t *Node;
+    int n;
+    /*********************************/
+
+    MemPool = (MemPool_t *)pool;
+    n = 0;
+
+    taskENTER_CRITICAL();
+
+    while (n < count) {
+
+        Node = PopOffStack(&MemPool->Stack);
+        if (Node == NULL) {
+            break;
+        }
+
+        items[n++] = (void *)(((unsigned char *)Node) + MemPool->Alignment);
+    }
+
+    StatsAllocated(MemPool, n);
+    StatsFailed(MemPool, count - n);
+
+    taskEXIT_CRITICAL();
+
+    return n;
+}
+
+
+void MemoryPoolFreeBatch(MemoryPool_t pool, void **items, int count)
+{
+    /*********************************/
+    MemPool_t *MemPool;
+    SlNode_t *Node;
+    int i;
+    int Wake;
+    /*********************************/
+
+    MemPool = (MemPool_t *)pool;
+
+    taskENTER_CRITICAL();
 
+    for (i = 0; i < count; i++) {
+
+        Node = (SlNode_t *)(((unsigned char *)items[i]) - MemPool->Alignment);
+        PushOnStack(&MemPool->Stack, Node);
+    }
+
+    StatsFreed(MemPool, count);
+    Wake = ClaimWaiters(MemPool, count);
+
+    taskEXIT_CRITICAL();
+
+    WakeWaiters(MemPool, Wake);
+}
+
+
+int MemoryPoolGetItemSize(MemoryPool_t pool)
+{
+    /*********************************/
+    MemPool_t *MemPool;
+    /*********************************/
+
+    MemPool = (MemPool_t *)pool;
+
+    /**
+     *  The front of each item is reserved for the stack link.
+     */
+    return MemPool->ItemSize - MemPool->Alignment;
+}
+
+
+#ifdef C_FREERTOS_MEMORY_POOL_STATS
+void MemoryPoolGetStats(MemoryPool_t pool, MemoryPoolStats_t *stats)
+{
+    /*********************************/
+    MemPool_t *MemPool;
+    /*********************************/
+
+    MemPool = (MemPool_t *)pool;
+
+    stats->TotalItems = __atomic_load_n(&MemPool->Stats.TotalItems, __ATOMIC_RELAXED);
+    stats->FreeItems = __atomic_load_n(&MemPool->Stats.FreeItems, __ATOMIC_RELAXED);
+    stats->LowWaterMark = __atomic_load_n(&MemPool->Stats.LowWaterMark, __ATOMIC_RELAXED);
+    stats->PeakUsage = __atomic_load_n(&MemPool->Stats.PeakUsage, __ATOMIC_RELAXED);
+    stats->Allocations = __atomic_load_n(&MemPool->Stats.Allocations, __ATOMIC_RELAXED);
+    stats->Frees = __atomic_load_n(&MemPool->Stats.Frees, __ATOMIC_RELAXED);
+    stats->FailedAllocations = __atomic_load_n(&MemPool->Stats.FailedAllocations, __ATOMIC_RELAXED);
+}
+#endif
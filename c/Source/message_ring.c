@@ -0,0 +1,542 @@
+/****************************************************************************
+ *
+ *  Copyright (c) 2023, Michael Becker (michael.f.becker@gmail.com)
+ *
+ *  This file is part of the FreeRTOS Add-ons project.
+ *
+ *  Source Code:
+ *  https://github.com/michaelbecker/freertos-addons
+ *
+ *  Project Page:
+ *  http://michaelbecker.github.io/freertos-addons/
+ *
+ *  On-line Documentation:
+ *  http://michaelbecker.github.io/freertos-addons/docs/html/index.html
+ *
+ *  MIT License
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files
+ *  (the "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so,subject to the
+ *  following conditions:
+ *
+ *  + The above copyright notice and this permission notice shall be included
+ *    in all copies or substantial portions of the Software.
+ *  + Credit is appreciated, but not required, if you find this project
+ *    useful enough to include in your application, product, device, etc.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ *  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ *  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ ***************************************************************************/
+
+
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "message_ring.h"
+
+
+/**
+ *  Everything in the ring is laid out in slots of this size. A
+ *  message is one slot holding its length, followed by its data
+ *  rounded up to whole slots.
+ */
+#define SLOT        ((int)sizeof(void *))
+
+
+/**
+ *  Length word telling the consumer the rest of the buffer is unused
+ *  and the next message is at the start.
+ */
+#define WRAP        (-1)
+
+
+/**
+ *  The actual MessageRing data structure.
+ */
+typedef struct PvtMessageRing_t_ {
+
+    /**
+     *  Start of the ring.
+     */
+    unsigned char *Buffer;
+
+    /**
+     *  Size of the ring in bytes, a whole number of slots.
+     */
+    int Size;
+
+    /**
+     *  Did we malloc the buffer?
+     */
+    int Allocated;
+
+    /**
+     *  Offset just past the last committed message. Only the 
+     *  producer writes this.
+     */
+    int Head;
+
+    /**
+     *  Offset of the oldest unreleased message. Only the consumer 
+     *  writes this.
+     */
+    int Tail;
+
+    /**
+     *  Offset and size in bytes of the outstanding reservation.
+     */
+    int Reserved;
+    int ReservedSize;
+
+    /**
+     *  Size in bytes of the message from the last peek.
+     */
+    int PeekedSize;
+
+    /**
+     *  Set while a task is about to block, so the other side only 
+     *  pays for a semaphore give when someone is waiting.
+     */
+    int ProducerWaiting;
+    int ConsumerWaiting;
+
+    /**
+     *  Given on release and commit, respectively.
+     */
+    SemaphoreHandle_t SpaceAvailable;
+    SemaphoreHandle_t DataAvailable;
+
+} PvtMessageRing_t;
+
+
+static int RoundUp(int Size)
+{
+    return (Size + SLOT - 1) & ~(SLOT - 1);
+}
+
+
+static PvtMessageRing_t *CreateMessageRingInternal( unsigned char *Buffer,
+                                                    int Size,
+                                                    int Allocated)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    /*********************************/
+
+    Size &= ~(SLOT - 1);
+
+    if (Size < 4 * SLOT || ((uintptr_t)Buffer & (SLOT - 1)) != 0) {
+        return NULL;
+    }
+
+    Ring = (PvtMessageRing_t *)malloc(sizeof(PvtMessageRing_t));
+    if (Ring == NULL) {
+        return NULL;
+    }
+
+    Ring->SpaceAvailable = xSemaphoreCreateBinary();
+    if (Ring->SpaceAvailable == NULL) {
+        free(Ring);
+        return NULL;
+    }
+
+    Ring->DataAvailable = xSemaphoreCreateBinary();
+    if (Ring->DataAvailable == NULL) {
+        vSemaphoreDelete(Ring->SpaceAvailable);
+        free(Ring);
+        return NULL;
+    }
+
+    Ring->Buffer = Buffer;
+    Ring->Size = Size;
+    Ring->Allocated = Allocated;
+    Ring->Head = 0;
+    Ring->Tail = 0;
+    Ring->Reserved = 0;
+    Ring->ReservedSize = 0;
+    Ring->PeekedSize = 0;
+    Ring->ProducerWaiting = 0;
+    Ring->ConsumerWaiting = 0;
+
+    return Ring;
+}
+
+
+MessageRing_t CreateMessageRing(int Size)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    unsigned char *Buffer;
+    /*********************************/
+
+    Buffer = (unsigned char *)malloc(Size);
+    if (Buffer == NULL) {
+        return NULL;
+    }
+
+    Ring = CreateMessageRingInternal(Buffer, Size, 1);
+    if (Ring == NULL) {
+        free(Buffer);
+        return NULL;
+    }
+
+    return (MessageRing_t)Ring;
+}
+
+
+MessageRing_t CreateMessageRingStatic(void *Buffer, int Size)
+{
+    return (MessageRing_t)CreateMessageRingInternal((unsigned char *)Buffer,
+                                                    Size,
+                                                    0);
+}
+
+
+void DeleteMessageRing(MessageRing_t ring)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    /*********************************/
+
+    Ring = (PvtMessageRing_t *)ring;
+
+    vSemaphoreDelete(Ring->DataAvailable);
+    vSemaphoreDelete(Ring->SpaceAvailable);
+
+    if (Ring->Allocated) {
+        free(Ring->Buffer);
+    }
+
+    free(Ring);
+}
+
+
+/**
+ *  Can this message ever be reserved? Anything up to half the ring 
+ *  fits on one side or the other of wherever the ring drains to.
+ */
+static int MessageFits(PvtMessageRing_t *Ring, int Size)
+{
+    return Size >= 0 && SLOT + RoundUp(Size) <= (Ring->Size - SLOT) / 2;
+}
+
+
+static void *TryReserve(PvtMessageRing_t *Ring, int Size)
+{
+    /*********************************/
+    int Needed;
+    int Head;
+    int Tail;
+    int Offset;
+    /*********************************/
+
+    Needed = SLOT + RoundUp(Size);
+    Head = Ring->Head;
+    Tail = __atomic_load_n(&Ring->Tail, __ATOMIC_ACQUIRE);
+
+    /**
+     *  Head can never be allowed to catch up with Tail, 
+     *  or a full ring would look empty.
+     */
+    if (Head >= Tail) {
+
+        if (Needed < Ring->Size - Head ||
+            (Needed == Ring->Size - Head && Tail != 0)) {
+
+            Offset = Head;
+        }
+        else if (Needed < Tail) {
+
+            /**
+             *  Not enough room at the end, start over at the 
+             *  beginning. The consumer can't see this until we 
+             *  commit.
+             */
+            *(int *)(Ring->Buffer + Head) = WRAP;
+            Offset = 0;
+        }
+        else {
+            return NULL;
+        }
+    }
+    else if (Needed < Tail - Head) {
+        Offset = Head;
+    }
+    else {
+        return NULL;
+    }
+
+    Ring->Reserved = Offset;
+    Ring->ReservedSize = Needed;
+
+    return Ring->Buffer + Offset + SLOT;
+}
+
+
+void *MessageRingReserve(MessageRing_t ring, int Size, TickType_t Timeout)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    TimeOut_t TimeOut;
+    void *Message;
+    /*********************************/
+
+    Ring = (PvtMessageRing_t *)ring;
+
+    if (!MessageFits(Ring, Size)) {
+        return NULL;
+    }
+
+    vTaskSetTimeOutState(&TimeOut);
+
+    while (1) {
+
+        Message = TryReserve(Ring, Size);
+
+        if (Message != NULL || Timeout == 0) {
+            return Message;
+        }
+
+        /**
+         *  Announce that we're waiting, then look again in case the
+         *  consumer released something before it could see that.
+         */
+        __atomic_store_n(&Ring->ProducerWaiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        Message = TryReserve(Ring, Size);
+
+        if (Message == NULL) {
+            xSemaphoreTake(Ring->SpaceAvailable, Timeout);
+        }
+
+        __atomic_store_n(&Ring->ProducerWaiting, 0, __ATOMIC_RELAXED);
+
+        if (Message != NULL) {
+            return Message;
+        }
+
+        if (xTaskCheckForTimeOut(&TimeOut, &Timeout) != pdFALSE) {
+            Timeout = 0;
+        }
+    }
+}
+
+
+void *MessageRingReserveFromISR(MessageRing_t ring, int Size)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    /*********************************/
+
+    Ring = (PvtMessageRing_t *)ring;
+
+    if (!MessageFits(Ring, Size)) {
+        return NULL;
+    }
+
+    return TryReserve(Ring, Size);
+}
+
+
+/**
+ *  Publish the reservation.
+ *
+ *  @return true if the consumer needs waking up.
+ */
+static int CommitInternal(PvtMessageRing_t *Ring, int Size)
+{
+    /*********************************/
+    int Needed;
+    int Head;
+    /*********************************/
+
+    Needed = SLOT + RoundUp(Size);
+    configASSERT(Size >= 0 && Needed <= Ring->ReservedSize);
+
+    *(int *)(Ring->Buffer + Ring->Reserved) = Size;
+
+    Head = Ring->Reserved + Needed;
+    if (Head == Ring->Size) {
+        Head = 0;
+    }
+
+    __atomic_store_n(&Ring->Head, Head, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&Ring->ConsumerWaiting, __ATOMIC_RELAXED);
+}
+
+
+void MessageRingCommit(MessageRing_t ring, int Size)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    /*********************************/
+
+    Ring = (PvtMessageRing_t *)ring;
+
+    if (CommitInternal(Ring, Size)) {
+        xSemaphoreGive(Ring->DataAvailable);
+    }
+}
+
+
+void MessageRingCommitFromISR(  MessageRing_t ring, 
+                                int Size, 
+                                BaseType_t *pxHigherPriorityTaskWoken)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    /*********************************/
+
+    Ring = (PvtMessageRing_t *)ring;
+
+    if (CommitInternal(Ring, Size)) {
+        xSemaphoreGiveFromISR(Ring->DataAvailable, pxHigherPriorityTaskWoken);
+    }
+}
+
+
+static void *TryPeek(PvtMessageRing_t *Ring, int *Size)
+{
+    /*********************************/
+    int Head;
+    int Tail;
+    int Length;
+    /*********************************/
+
+    Head = __atomic_load_n(&Ring->Head, __ATOMIC_ACQUIRE);
+    Tail = Ring->Tail;
+
+    while (Tail != Head) {
+
+        Length = *(int *)(Ring->Buffer + Tail);
+
+        if (Length == WRAP) {
+            Tail = 0;
+            __atomic_store_n(&Ring->Tail, Tail, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        Ring->PeekedSize = SLOT + RoundUp(Length);
+        *Size = Length;
+
+        return Ring->Buffer + Tail + SLOT;
+    }
+
+    return NULL;
+}
+
+
+void *MessageRingPeek(MessageRing_t ring, int *Size, TickType_t Timeout)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    TimeOut_t TimeOut;
+    void *Message;
+    /*********************************/
+
+    Ring = (PvtMessageRing_t *)ring;
+
+    vTaskSetTimeOutState(&TimeOut);
+
+    while (1) {
+
+        Message = TryPeek(Ring, Size);
+
+        if (Message != NULL || Timeout == 0) {
+            return Message;
+        }
+
+        __atomic_store_n(&Ring->ConsumerWaiting, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        Message = TryPeek(Ring, Size);
+
+        if (Message == NULL) {
+            xSemaphoreTake(Ring->DataAvailable, Timeout);
+        }
+
+        __atomic_store_n(&Ring->ConsumerWaiting, 0, __ATOMIC_RELAXED);
+
+        if (Message != NULL) {
+            return Message;
+        }
+
+        if (xTaskCheckForTimeOut(&TimeOut, &Timeout) != pdFALSE) {
+            Timeout = 0;
+        }
+    }
+}
+
+
+void *MessageRingPeekFromISR(MessageRing_t ring, int *Size)
+{
+    return TryPeek((PvtMessageRing_t *)ring, Size);
+}
+
+
+/**
+ *  Give the peeked message back.
+ *
+ *  @return true if the producer needs waking up.
+ */
+static int ReleaseInternal(PvtMessageRing_t *Ring)
+{
+    /*********************************/
+    int Tail;
+    /*********************************/
+
+    Tail = Ring->Tail + Ring->PeekedSize;
+    if (Tail == Ring->Size) {
+        Tail = 0;
+    }
+
+    __atomic_store_n(&Ring->Tail, Tail, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&Ring->ProducerWaiting, __ATOMIC_RELAXED);
+}
+
+
+void MessageRingRelease(MessageRing_t ring)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    /*********************************/
+
+    Ring = (PvtMessageRing_t *)ring;
+
+    if (ReleaseInternal(Ring)) {
+        xSemaphoreGive(Ring->SpaceAvailable);
+    }
+}
+
+
+void MessageRingReleaseFromISR( MessageRing_t ring, 
+                                BaseType_t *pxHigherPriorityTaskWoken)
+{
+    /*********************************/
+    PvtMessageRing_t *Ring;
+    /*********************************/
+
+    Ring = (PvtMessageRing_t *)ring;
+
+    if (ReleaseInternal(Ring)) {
+        xSemaphoreGiveFromISR(Ring->SpaceAvailable, pxHigherPriorityTaskWoken);
+    }
+}
@@ -42,6 +42,7 @@
 
 #include <stdlib.h>
 #include "FreeRTOS.h"
+#include "task.h"
 #include "queue.h"
 #include "mem_pool.h"
 #include "zero_copy_queue.h"
@@ -76,8 +77,8 @@ ZeroCopyQueue_t ZcqCreateQueue( int ItemSize,
 
     zcq->Pool = CreateMemoryPool(ItemSize, ItemCount, Alignment);
     if (zcq->Pool == NULL) {
-        free(zcq);
         vQueueDelete(zcq->Handle);
+        free(zcq);
         return NULL;
     }
 
@@ -147,3 +148,147 @@ void *ZcqDequeueItem(   ZeroCopyQueue_t z,
 }
 
 
+void *ZcqAllocateItemFromISR(ZeroCopyQueue_t z)
+{
+    /******************************/
+    PvtZeroCopyQueue_t *zcq;
+    /******************************/
+
+    zcq = (PvtZeroCopyQueue_t *)z;
+
+    return MemoryPoolAllocateFromISR(zcq->Pool);
+}
+
+
+void ZcqFreeItemFromISR(ZeroCopyQueue_t z, 
+                        void *Item,
+                        BaseType_t *pxHigherPriorityTaskWoken)
+{
+    /******************************/
+    PvtZeroCopyQueue_t *zcq;
+    /******************************/
+
+    zcq = (PvtZeroCopyQueue_t *)z;
+
+    MemoryPoolFreeFromISR(zcq->Pool, Item, pxHigherPriorityTaskWoken);
+}
+
+
+int ZcqEnqueueItemFromISR(  ZeroCopyQueue_t z, 
+                            void *Item, 
+                            BaseType_t *pxHigherPriorityTaskWoken)
+{
+    /******************************/
+    PvtZeroCopyQueue_t *zcq;
+    BaseType_t success;
+    /******************************/
+
+    zcq = (PvtZeroCopyQueue_t *)z;
+
+    success = xQueueSendToBackFromISR(zcq->Handle, &Item, pxHigherPriorityTaskWoken);
+
+    return success == pdTRUE ? 1 : 0;
+}
+
+
+void *ZcqDequeueItemFromISR(ZeroCopyQueue_t z,
+                            BaseType_t *pxHigherPriorityTaskWoken)
+{
+    /******************************/
+    PvtZeroCopyQueue_t *zcq;
+    BaseType_t success;
+    void *Item;
+    /******************************/
+
+    zcq = (PvtZeroCopyQueue_t *)z;
+
+    success = xQueueReceiveFromISR(zcq->Handle, &Item, pxHigherPriorityTaskWoken);
+
+    return success == pdTRUE ? Item : NULL;
+}
+
+
+int ZcqEnqueueBatch(ZeroCopyQueue_t z, 
+                    void **Items, 
+                    int Count, 
+                    TickType_t Timeout)
+{
+    /******************************/
+    PvtZeroCopyQueue_t *zcq;
+    TimeOut_t TimeOut;
+    int i;
+    /******************************/
+
+    zcq = (PvtZeroCopyQueue_t *)z;
+
+    vTaskSetTimeOutState(&TimeOut);
+
+    for (i = 0; i < Count; i++) {
+
+        if (xQueueSendToBack(zcq->Handle, &Items[i], Timeout) != pdTRUE) {
+            break;
+        }
+
+        /**
+         *  The timeout covers the whole batch, not each item.
+         */
+        if (xTaskCheckForTimeOut(&TimeOut, &Timeout) != pdFALSE) {
+            Timeout = 0;
+        }
+    }
+
+    return i;
+}
+
+
+int ZcqEnqueueBatchFromISR( ZeroCopyQueue_t z, 
+                            void **Items, 
+                            int Count, 
+                            BaseType_t *pxHigherPriorityTaskWoken)
+{
+    /******************************/
+    PvtZeroCopyQueue_t *zcq;
+    int i;
+    /******************************/
+
+    zcq = (PvtZeroCopyQueue_t *)z;
+
+    for (i = 0; i < Count; i++) {
+        if (xQueueSendToBackFromISR(zcq->Handle, &Items[i], 
+                                    pxHigherPriorityTaskWoken) != pdTRUE) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+
+int ZcqDequeueBatch(ZeroCopyQueue_t z, 
+                    void **Items, 
+                    int Count, 
+                    TickType_t Timeout)
+{
+    /******************************/
+    PvtZeroCopyQueue_t *zcq;
+    int i;
+    /******************************/
+
+    zcq = (PvtZeroCopyQueue_t *)z;
+
+    if (Count <= 0) {
+        return 0;
+    }
+
+    if (xQueueReceive(zcq->Handle, &Items[0], Timeout) != pdTRUE) {
+        return 0;
+    }
+
+    for (i = 1; i < Count; i++) {
+        if (xQueueReceive(zcq->Handle, &Items[i], 0) != pdTRUE) {
+            break;
+        }
+    }
+
+    return i;
+}